@@ -3,20 +3,26 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <climits>
 #include <cmath>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <iterator>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <variant>
@@ -27,6 +33,7 @@
 #include "calendar.h"
 #include "cata_assert.h"
 #include "cata_path.h"
+#include "cata_scope_helpers.h"
 #include "cata_utility.h"
 #include "catacharset.h"
 #include "character.h"
@@ -43,6 +50,7 @@
 #include "enums.h"
 #include "field.h"
 #include "field_type.h"
+#include "filesystem.h"
 #include "flexbuffer_json.h"
 #include "game.h"
 #include "input.h"
@@ -62,6 +70,7 @@
 #include "mapdata.h"
 #include "maptile_fwd.h"
 #include "mdarray.h"
+#include "mmap_file.h"
 #include "mod_tileset.h"
 #include "monster.h"
 #include "monstergenerator.h"
@@ -70,6 +79,7 @@
 #include "npc.h"
 #include "npc_attack.h"
 #include "omdata.h"
+#include "options.h"
 #include "output.h"
 #include "overlay_ordering.h"
 #include "overmap.h"
@@ -97,6 +107,10 @@
 #include "weather_type.h"
 #include "weighted_list.h"
 
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
 #define dbg(x) DebugLog((x),D_SDL) << __FILE__ << ":" << __LINE__ << ": "
 
 static const efftype_id effect_ridden( "ridden" );
@@ -277,6 +291,8 @@ void cata_tiles::on_options_changed()
 
 void tileset::clear()
 {
+    // Their sprite indices are about to become meaningless
+    pending_variants.clear();
     tile_values.clear();
     shadow_tile_values.clear();
     night_tile_values.clear();
@@ -365,6 +381,9 @@ void cata_tiles::load_tileset( const std::string &tileset_id, const bool prechec
     tileset_mutation_overlay_ordering.clear();
 
     tileset_ptr = cache.load_tileset( tileset_id, renderer, precheck, force, pump_events, terrain );
+    // Counted across all contexts, so no two contexts ever share a generation
+    static int last_tileset_generation = 0;
+    tileset_generation = ++last_tileset_generation;
 
     set_draw_scale( 16 );
 
@@ -429,32 +448,6 @@ static void get_tile_information( const cata_path &config_path, std::string &jso
     }
 }
 
-template<typename PixelConverter>
-static SDL_Surface_Ptr apply_color_filter( const SDL_Surface_Ptr &original,
-        PixelConverter pixel_converter )
-{
-    cata_assert( original );
-    SDL_Surface_Ptr surf = create_surface_32( original->w, original->h );
-    cata_assert( surf );
-    throwErrorIf( SDL_BlitSurface( original.get(), nullptr, surf.get(), nullptr ) != 0,
-                  "SDL_BlitSurface failed" );
-
-    SDL_Color *pix = static_cast<SDL_Color *>( surf->pixels );
-
-    for( int y = 0, ey = surf->h; y < ey; ++y ) {
-        for( int x = 0, ex = surf->w; x < ex; ++x, ++pix ) {
-            if( pix->a == 0x00 ) {
-                // This check significantly improves the performance since
-                // vast majority of pixels in the tilesets are completely transparent.
-                continue;
-            }
-            *pix = pixel_converter( *pix );
-        }
-    }
-
-    return surf;
-}
-
 static bool is_contained( const SDL_Rect &smaller, const SDL_Rect &larger )
 {
     return smaller.x >= larger.x &&
@@ -463,10 +456,26 @@ static bool is_contained( const SDL_Rect &smaller, const SDL_Rect &larger )
            smaller.y + smaller.h <= larger.y + larger.h;
 }
 
-void tileset_cache::loader::copy_surface_to_texture( const SDL_Surface_Ptr &surf,
-        const point &offset, std::vector<texture> &target )
+namespace
+{
+/** Where the sprites of one tileset image go among the textures of a tileset. */
+struct sprite_layout {
+    // Of the image within the atlas it was cut from
+    point offset;
+    // Index of the first sprite of the atlas
+    int first_index;
+    point sprite_size;
+    int atlas_width;
+};
+} // namespace
+
+static void copy_sprites_to_textures( const SDL_Renderer_Ptr &renderer,
+                                      const SDL_Surface_Ptr &surf, const sprite_layout &layout,
+                                      std::vector<texture> &target )
 {
     cata_assert( surf );
+    const int sprite_width = layout.sprite_size.x;
+    const int sprite_height = layout.sprite_size.y;
     const rect_range<SDL_Rect> input_range( sprite_width, sprite_height,
                                             point( surf->w / sprite_width,
                                                     surf->h / sprite_height ) );
@@ -475,48 +484,500 @@ void tileset_cache::loader::copy_surface_to_texture( const SDL_Surface_Ptr &surf
     cata_assert( texture_ptr );
 
     for( const SDL_Rect rect : input_range ) {
-        cata_assert( offset.x % sprite_width == 0 );
-        cata_assert( offset.y % sprite_height == 0 );
-        const point pos( offset + point( rect.x, rect.y ) );
+        cata_assert( layout.offset.x % sprite_width == 0 );
+        cata_assert( layout.offset.y % sprite_height == 0 );
+        const point pos( layout.offset + point( rect.x, rect.y ) );
         cata_assert( pos.x % sprite_width == 0 );
         cata_assert( pos.y % sprite_height == 0 );
-        const size_t index = this->offset + ( pos.x / sprite_width ) + ( pos.y / sprite_height ) *
-                             ( tile_atlas_width / sprite_width );
+        const size_t index = layout.first_index + ( pos.x / sprite_width ) +
+                             ( pos.y / sprite_height ) * ( layout.atlas_width / sprite_width );
         cata_assert( index < target.size() );
         cata_assert( target[index].dimension() == std::make_pair( 0, 0 ) );
         target[index] = texture( texture_ptr, rect );
     }
 }
 
+void tileset_cache::loader::copy_surface_to_texture( const SDL_Surface_Ptr &surf,
+        const point &offset, std::vector<texture> &target )
+{
+    copy_sprites_to_textures( renderer, surf,
+    { offset, this->offset, point( sprite_width, sprite_height ), tile_atlas_width }, target );
+}
+
+/**
+ * A color filtered variant of one tileset image. A filter worker filters it while the
+ * tileset is already in use, the render thread uploads it once it's filtered.
+ */
+struct tileset::pending_variant {
+    std::vector<texture> *target = nullptr;
+    // Of the whole image, the offset is that of each sub rect
+    sprite_layout layout;
+    // The parts the image is split into to fit in a texture
+    std::vector<SDL_Rect> sub_rects;
+    const SDL_Renderer_Ptr *renderer = nullptr;
+
+    SDL_Surface_Ptr surface;
+    // Owns the pixels of variants wrapped from the on-disk cache
+    std::shared_ptr<mmap_file> mapped;
+    std::exception_ptr error;
+    // Set by the worker once surface or error may be read
+    std::atomic<bool> filtered{ false };
+};
+
+tileset::tileset() = default;
+
+tileset::~tileset() = default;
+
+void tileset::upload_filtered_variants()
+{
+    for( std::shared_ptr<pending_variant> &pending : pending_variants ) {
+        if( !pending->filtered.load( std::memory_order_acquire ) ) {
+            continue;
+        }
+        try {
+            if( pending->error ) {
+                std::rethrow_exception( pending->error );
+            }
+            const SDL_Surface &surf = *pending->surface;
+            for( const SDL_Rect &sub_rect : pending->sub_rects ) {
+                // Points into the filtered image instead of copying the part
+                const int w = std::min( surf.w - sub_rect.x, sub_rect.w );
+                const int h = std::min( surf.h - sub_rect.y, sub_rect.h );
+                uint8_t *const pixels = static_cast<uint8_t *>( surf.pixels ) +
+                                        static_cast<size_t>( sub_rect.y ) * surf.pitch +
+                                        static_cast<size_t>( sub_rect.x ) * surf.format->BytesPerPixel;
+                const SDL_Surface_Ptr part( SDL_CreateRGBSurfaceWithFormatFrom( pixels, w, h, 32,
+                                            surf.pitch, surf.format->format ) );
+                throwErrorIf( !part, "SDL_CreateRGBSurfaceWithFormatFrom failed" );
+                sprite_layout layout = pending->layout;
+                layout.offset = point( sub_rect.x, sub_rect.y );
+                copy_sprites_to_textures( *pending->renderer, part, layout, *pending->target );
+            }
+        } catch( const std::exception &err ) {
+            debugmsg( "Failed to color filter a tileset image, using its unfiltered sprites: %s",
+                      err.what() );
+        }
+        // The worker may still be writing the cache entry, it holds on to the variant
+        pending.reset();
+    }
+    pending_variants.erase( std::remove( pending_variants.begin(), pending_variants.end(), nullptr ),
+                            pending_variants.end() );
+}
+
+void tileset_cache::upload_filtered_variants()
+{
+    for( const auto &entry : tilesets_ ) {
+        if( const std::shared_ptr<tileset> ts = entry.second.lock() ) {
+            ts->upload_filtered_variants();
+        }
+    }
+}
+
+/**
+ * Color filtered atlases are cached on disk, one file per tileset image and filter, so
+ * later launches can skip filtering and map the result directly. The file remembers a
+ * hash of the unfiltered pixels it was made from and is replaced once the image changes.
+ */
+namespace filtered_atlas_cache
+{
+
+// Bump when the color filters or the file layout change
+static constexpr uint32_t version = 2;
+static constexpr uint32_t magic = 0x54414643; // "CFAT"
+// A few tilesets' worth, entries of tilesets not loaded for a while are dropped past this
+static constexpr uintmax_t max_total_bytes = uintmax_t( 1024 ) * 1024 * 1024;
+
+struct header {
+    uint32_t magic;
+    uint32_t version;
+    int32_t w;
+    int32_t h;
+    int32_t pitch;
+    uint32_t padding;
+    uint64_t pixel_hash;
+};
+static_assert( sizeof( header ) == 32, "keeps the mapped pixels aligned" );
+
+static uint64_t hash_bytes( const void *bytes, size_t len )
+{
+    // FNV-1a over 64 bit words, good enough to tell atlases apart
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const uint8_t *data = static_cast<const uint8_t *>( bytes );
+    size_t i = 0;
+    for( ; i + sizeof( uint64_t ) <= len; i += sizeof( uint64_t ) ) {
+        uint64_t word;
+        std::memcpy( &word, data + i, sizeof( word ) );
+        hash = ( hash ^ word ) * 0x100000001b3ULL;
+    }
+    for( ; i < len; i++ ) {
+        hash = ( hash ^ data[i] ) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static uint64_t hash_pixels( const SDL_Surface &surf )
+{
+    return hash_bytes( surf.pixels, static_cast<size_t>( surf.pitch ) * surf.h );
+}
+
+static std::filesystem::path directory()
+{
+    return ( PATH_INFO::user_dir_path() / "cache" / "tileset_filters" /
+             ( "v" + std::to_string( version ) ) ).get_unrelative_path();
+}
+
+/**
+ * Drops the caches of older versions, then the least recently used entries until the
+ * rest fits in max_total_bytes. Entries are touched whenever they're loaded.
+ */
+static void prune()
+{
+    std::error_code ec;
+    const std::filesystem::path dir = directory();
+    std::vector<std::filesystem::path> old_versions;
+    for( std::filesystem::directory_iterator it( dir.parent_path(), ec ), end; !ec && it != end;
+         it.increment( ec ) ) {
+        if( it->path() != dir ) {
+            old_versions.push_back( it->path() );
+        }
+    }
+    for( const std::filesystem::path &old_version : old_versions ) {
+        std::filesystem::remove_all( old_version, ec );
+    }
+
+    struct entry {
+        std::filesystem::path path;
+        std::filesystem::file_time_type last_used;
+        uintmax_t size;
+    };
+    std::vector<entry> entries;
+    uintmax_t total_size = 0;
+    ec.clear();
+    for( std::filesystem::directory_iterator it( dir, ec ), end; !ec && it != end;
+         it.increment( ec ) ) {
+        std::error_code entry_ec;
+        const uintmax_t size = it->file_size( entry_ec );
+        const std::filesystem::file_time_type last_used = it->last_write_time( entry_ec );
+        if( !entry_ec ) {
+            entries.push_back( { it->path(), last_used, size } );
+            total_size += size;
+        }
+    }
+    if( total_size <= max_total_bytes ) {
+        return;
+    }
+    std::sort( entries.begin(), entries.end(), []( const entry & lhs, const entry & rhs ) {
+        return lhs.last_used < rhs.last_used;
+    } );
+    for( const entry &oldest : entries ) {
+        if( total_size <= max_total_bytes ) {
+            break;
+        }
+        if( std::filesystem::remove( oldest.path, ec ) ) {
+            total_size -= oldest.size;
+        }
+    }
+}
+
+static std::filesystem::path file_for( const cata_path &img_path, const std::string &filter )
+{
+    std::string filter_key = filter;
+    if( filter == "color_pixel_custom" ) {
+        // The only filter with parameters
+        for( const char *opt : {
+                 "MEMORY_RGB_DARK_RED", "MEMORY_RGB_DARK_GREEN", "MEMORY_RGB_DARK_BLUE",
+                 "MEMORY_RGB_BRIGHT_RED", "MEMORY_RGB_BRIGHT_GREEN", "MEMORY_RGB_BRIGHT_BLUE"
+             } ) {
+            filter_key += "_" + std::to_string( get_option<int>( opt ) );
+        }
+        filter_key += "_" + std::to_string( get_option<float>( "MEMORY_GAMMA" ) );
+    }
+    // The name is for telling entries apart by eye, the hash for images sharing one
+    const std::string image = img_path.generic_u8string();
+    return directory() / string_format( "%s_%016llx_%s.px",
+                                        img_path.get_unrelative_path().stem().u8string(),
+                                        static_cast<unsigned long long>( hash_bytes( image.data(), image.size() ) ),
+                                        filter_key );
+}
+
+/**
+ * Returns the mapped file if it holds a filtered atlas of the same layout as @p like,
+ * made from pixels with the hash @p pixel_hash.
+ */
+static std::shared_ptr<mmap_file> load( const std::filesystem::path &path, const SDL_Surface &like,
+                                        uint64_t pixel_hash )
+{
+    std::error_code ec;
+    if( !std::filesystem::exists( path, ec ) ) {
+        return nullptr;
+    }
+    std::shared_ptr<mmap_file> mapped = mmap_file::map_file( path );
+    if( !mapped || mapped->len < sizeof( header ) ) {
+        return nullptr;
+    }
+    header head;
+    std::memcpy( &head, mapped->base, sizeof( head ) );
+    if( head.magic != magic || head.version != version || head.w != like.w || head.h != like.h ||
+        head.pitch != like.pitch || head.pixel_hash != pixel_hash ||
+        mapped->len != sizeof( header ) + static_cast<size_t>( like.pitch ) * like.h ) {
+        return nullptr;
+    }
+    // Marks it as recently used for prune
+    std::filesystem::last_write_time( path, std::filesystem::file_time_type::clock::now(), ec );
+    return mapped;
+}
+
+/** Wraps the pixels of a mapped file without copying them, the file has to outlive it. */
+static SDL_Surface_Ptr surface_from( const mmap_file &mapped, const SDL_Surface &like )
+{
+    SDL_Surface_Ptr surf( SDL_CreateRGBSurfaceWithFormatFrom( mapped.base + sizeof( header ),
+                          like.w, like.h, 32, like.pitch, like.format->format ) );
+    throwErrorIf( !surf, "SDL_CreateRGBSurfaceWithFormatFrom failed" );
+    return surf;
+}
+
+/**
+ * Written to a temporary file first, so a crash never leaves a truncated entry behind.
+ * @param writer_id Tells apart the temporary files of variants that share a filter.
+ */
+static void save( const std::filesystem::path &path, const SDL_Surface &surf, uint64_t pixel_hash,
+                  size_t writer_id )
+{
+    std::filesystem::path tmp_path = path;
+    tmp_path += ".tmp" + std::to_string( writer_id );
+    {
+        std::ofstream fout( tmp_path, std::ofstream::binary );
+        if( !fout.good() ) {
+            return;
+        }
+        const header head{ magic, version, surf.w, surf.h, surf.pitch, 0, pixel_hash };
+        fout.write( reinterpret_cast<const char *>( &head ), sizeof( head ) );
+        fout.write( static_cast<const char *>( surf.pixels ),
+                    static_cast<std::streamsize>( surf.pitch ) * surf.h );
+        if( !fout.good() ) {
+            fout.close();
+            std::error_code ec;
+            std::filesystem::remove( tmp_path, ec );
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename( tmp_path, path, ec );
+}
+
+} // namespace filtered_atlas_cache
+
+namespace
+{
+
+/**
+ * The threads color filters run on, at most one per core. They're started as jobs come in
+ * and then wait for more, every tileset image queues a job per filtered variant.
+ */
+class filter_pool
+{
+    public:
+        static filter_pool &instance() {
+            static filter_pool pool;
+            return pool;
+        }
+
+        filter_pool( const filter_pool & ) = delete;
+        filter_pool &operator=( const filter_pool & ) = delete;
+
+        ~filter_pool() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                stopping = true;
+            }
+            jobs_cv.notify_all();
+            for( std::thread &worker : workers ) {
+                worker.join();
+            }
+        }
+
+        void push( std::function<void()> job ) {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                jobs.push_back( std::move( job ) );
+                if( num_idle == 0 && workers.size() < std::max( std::thread::hardware_concurrency(), 1u ) ) {
+                    workers.emplace_back( [this]() {
+                        work();
+                    } );
+                }
+            }
+            jobs_cv.notify_one();
+        }
+
+    private:
+        filter_pool() = default;
+
+        void work() {
+            std::unique_lock<std::mutex> lock( mutex );
+            while( true ) {
+                ++num_idle;
+                jobs_cv.wait( lock, [this]() {
+                    return stopping || !jobs.empty();
+                } );
+                --num_idle;
+                if( stopping ) {
+                    return;
+                }
+                const std::function<void()> job = std::move( jobs.front() );
+                jobs.pop_front();
+                lock.unlock();
+                job();
+                lock.lock();
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable jobs_cv;
+        std::deque<std::function<void()>> jobs;
+        std::vector<std::thread> workers;
+        size_t num_idle = 0;
+        bool stopping = false;
+};
+
+} // namespace
+
+std::array<std::pair<std::vector<texture> *, std::string>, 5>
+tileset_cache::loader::color_variants()
+{
+    return {{
+            { &ts.tile_values, "color_pixel_none" },
+            { &ts.shadow_tile_values, "color_pixel_grayscale" },
+            { &ts.night_tile_values, "color_pixel_nightvision" },
+            { &ts.overexposed_tile_values, "color_pixel_overexposed" },
+            { &ts.memory_tile_values, tilecontext->memory_map_mode }
+        }
+    };
+}
+
 void tileset_cache::loader::create_textures_from_tile_atlas( const SDL_Surface_Ptr &tile_atlas,
         const point &offset )
 {
     cata_assert( tile_atlas );
+    for( const std::pair<std::vector<texture> *, std::string> &variant : color_variants() ) {
+        if( !get_color_pixel_function( variant.second ) ) {
+            copy_surface_to_texture( tile_atlas, offset, *variant.first );
+        }
+    }
+}
+
+void tileset_cache::loader::queue_filtered_variants( const SDL_Surface_Ptr &tile_atlas,
+        const cata_path &img_path, const std::vector<SDL_Rect> &sub_rects )
+{
+    cata_assert( tile_atlas );
 
-    /** perform color filter conversion here */
-    using tiles_pixel_color_entry = std::tuple<std::vector<texture>*, std::string>;
-    std::array<tiles_pixel_color_entry, 5> tile_values_data = {{
-            { std::make_tuple( &ts.tile_values, "color_pixel_none" ) },
-            { std::make_tuple( &ts.shadow_tile_values, "color_pixel_grayscale" ) },
-            { std::make_tuple( &ts.night_tile_values, "color_pixel_nightvision" ) },
-            { std::make_tuple( &ts.overexposed_tile_values, "color_pixel_overexposed" ) },
-            { std::make_tuple( &ts.memory_tile_values, tilecontext->memory_map_mode ) }
+    // Filtering only touches the pixels of private 32 bit copies, so it runs on the filter
+    // workers while the tileset is already in use: until tileset::upload_filtered_variants
+    // picks a variant up, its sprites are empty and the unfiltered ones are drawn instead.
+    // Variants found in the on-disk cache aren't filtered at all.
+    // Blitting from the (possibly RLE encoded) atlas isn't thread safe, so that's done once
+    // up front and the workers copy the raw pixels.
+    std::shared_ptr<SDL_Surface> atlas_32;
+    uint64_t pixel_hash = 0;
+    size_t i = 0;
+    for( const std::pair<std::vector<texture> *, std::string> &variant : color_variants() ) {
+        const color_pixel_function_pointer filter = get_color_pixel_function( variant.second );
+        const size_t writer_id = i++;
+        if( !filter ) {
+            continue;
         }
-    };
-    for( tiles_pixel_color_entry &entry : tile_values_data ) {
-        std::vector<texture> *tile_values = std::get<0>( entry );
-        color_pixel_function_pointer color_pixel_function = get_color_pixel_function( std::get<1>
-                ( entry ) );
-        if( !color_pixel_function ) {
-            // TODO: Move it inside apply_color_filter.
-            copy_surface_to_texture( tile_atlas, offset, *tile_values );
-        } else {
-            copy_surface_to_texture( apply_color_filter( tile_atlas, color_pixel_function ), offset,
-                                     *tile_values );
+        if( !atlas_32 ) {
+            atlas_32 = create_surface_32( tile_atlas->w, tile_atlas->h );
+            cata_assert( atlas_32 );
+            throwErrorIf( SDL_BlitSurface( tile_atlas.get(), nullptr, atlas_32.get(), nullptr ) != 0,
+                          "SDL_BlitSurface failed" );
+            pixel_hash = filtered_atlas_cache::hash_pixels( *atlas_32 );
+            assure_dir_exist( filtered_atlas_cache::directory() );
+        }
+        std::shared_ptr<tileset::pending_variant> pending =
+            std::make_shared<tileset::pending_variant>();
+        pending->target = variant.first;
+        pending->layout = { point::zero, this->offset, point( sprite_width, sprite_height ),
+                            tile_atlas_width
+                          };
+        pending->sub_rects = sub_rects;
+        pending->renderer = &renderer;
+        const std::filesystem::path cache_path = filtered_atlas_cache::file_for( img_path,
+                variant.second );
+        pending->mapped = filtered_atlas_cache::load( cache_path, *atlas_32, pixel_hash );
+        if( pending->mapped ) {
+            pending->surface = filtered_atlas_cache::surface_from( *pending->mapped, *atlas_32 );
+            pending->filtered = true;
+            ts.pending_variants.push_back( pending );
+            continue;
         }
+        pending->surface = create_surface_32( tile_atlas->w, tile_atlas->h );
+        cata_assert( pending->surface );
+        cata_assert( pending->surface->pitch == atlas_32->pitch );
+        ts.pending_variants.push_back( pending );
+        filter_pool::instance().push( [weak = std::weak_ptr<tileset::pending_variant>( pending ),
+                   atlas_32, filter, cache_path, pixel_hash, writer_id]() {
+            // Dropped if the tileset was cleared or unloaded before the job came up
+            const std::shared_ptr<tileset::pending_variant> variant = weak.lock();
+            if( !variant ) {
+                return;
+            }
+            try {
+                SDL_Surface &surf = *variant->surface;
+                std::memcpy( surf.pixels, atlas_32->pixels,
+                             static_cast<size_t>( atlas_32->pitch ) * atlas_32->h );
+                apply_color_filter( static_cast<SDL_Color *>( surf.pixels ),
+                                    static_cast<size_t>( surf.w ) * surf.h, filter );
+            } catch( ... ) {
+                variant->error = std::current_exception();
+            }
+            // Ready for upload, writing the cache entry only holds up the next launch
+            variant->filtered.store( true, std::memory_order_release );
+            if( !variant->error ) {
+                filtered_atlas_cache::save( cache_path, *variant->surface, pixel_hash, writer_id );
+            }
+        } );
     }
 }
 
+/**
+ * Decodes an image on a worker thread, so it's ready by the time the previous
+ * tileset image has been turned into textures.
+ */
+class image_prefetch
+{
+    public:
+        explicit image_prefetch( const cata_path &path ) :
+            worker( [this, file = path.get_unrelative_path().u8string()]() {
+            try {
+                surface = load_image( file.c_str() );
+            } catch( ... ) {
+                error = std::current_exception();
+            }
+        } ) {}
+        image_prefetch( const image_prefetch & ) = delete;
+        image_prefetch &operator=( const image_prefetch & ) = delete;
+        ~image_prefetch() {
+            if( worker.joinable() ) {
+                worker.join();
+            }
+        }
+
+        /** @throw std::exception If the image can not be loaded. */
+        SDL_Surface_Ptr get() {
+            worker.join();
+            if( error ) {
+                std::rethrow_exception( error );
+            }
+            return std::move( surface );
+        }
+
+    private:
+        SDL_Surface_Ptr surface;
+        std::exception_ptr error;
+        // Last, so it starts once everything it writes to exists
+        std::thread worker;
+};
+
 template<typename T>
 static void extend_vector_by( std::vector<T> &vec, const size_t additional_size )
 {
@@ -524,10 +985,16 @@ static void extend_vector_by( std::vector<T> &vec, const size_t additional_size
 }
 
 void tileset_cache::loader::load_tileset( const cata_path &img_path, const bool pump_events )
+{
+    load_tileset( load_image( img_path.get_unrelative_path().u8string().c_str() ), img_path,
+                  pump_events );
+}
+
+void tileset_cache::loader::load_tileset( const SDL_Surface_Ptr &tile_atlas,
+        const cata_path &img_path, const bool pump_events )
 {
     cata_assert( sprite_width > 0 );
     cata_assert( sprite_height > 0 );
-    const SDL_Surface_Ptr tile_atlas = load_image( img_path.get_unrelative_path().u8string().c_str() );
     cata_assert( tile_atlas );
     tile_atlas_width = tile_atlas->w;
 
@@ -598,7 +1065,9 @@ void tileset_cache::loader::load_tileset( const cata_path &img_path, const bool
     extend_vector_by( ts.overexposed_tile_values, expected_tilecount );
     extend_vector_by( ts.memory_tile_values, expected_tilecount );
 
+    std::vector<SDL_Rect> sub_rects;
     for( const SDL_Rect sub_rect : output_range ) {
+        sub_rects.push_back( sub_rect );
         cata_assert( sub_rect.x % sprite_width == 0 );
         cata_assert( sub_rect.y % sprite_height == 0 );
         cata_assert( sub_rect.w % sprite_width == 0 );
@@ -627,6 +1096,7 @@ void tileset_cache::loader::load_tileset( const cata_path &img_path, const bool
             inp_mngr.pump_events();
         }
     }
+    queue_filtered_variants( tile_atlas, img_path, sub_rects );
 
     size = expected_tilecount;
 }
@@ -718,6 +1188,8 @@ void tileset_cache::loader::load( const std::string &tileset_id, const bool prec
     }
 
     ts.clear();
+    // Before this load touches or adds entries, so its own are the last to go
+    filtered_atlas_cache::prune();
 
     // Load tile information if available.
     offset = 0;
@@ -820,8 +1292,23 @@ void tileset_cache::loader::load_internal( const JsonObject &config,
         // new system, several entries
         // When loading multiple tileset images this defines where
         // the tiles from the most recently loaded image start from.
+        std::vector<cata_path> tileset_image_paths;
         for( const JsonObject tile_part_def : config.get_array( "tiles-new" ) ) {
-            const cata_path tileset_image_path = tileset_root / tile_part_def.get_string( "file" );
+            tileset_image_paths.push_back( tileset_root / tile_part_def.get_string( "file" ) );
+        }
+        // Decoding the next image overlaps with turning the current one into textures
+        std::unique_ptr<image_prefetch> next_image;
+        if( !tileset_image_paths.empty() ) {
+            next_image = std::make_unique<image_prefetch>( tileset_image_paths.front() );
+        }
+        size_t part_idx = 0;
+        for( const JsonObject tile_part_def : config.get_array( "tiles-new" ) ) {
+            const cata_path &tileset_image_path = tileset_image_paths[part_idx];
+            std::unique_ptr<image_prefetch> this_image = std::move( next_image );
+            part_idx++;
+            if( part_idx < tileset_image_paths.size() ) {
+                next_image = std::make_unique<image_prefetch>( tileset_image_paths[part_idx] );
+            }
             R = -1;
             G = -1;
             B = -1;
@@ -855,7 +1342,7 @@ void tileset_cache::loader::load_internal( const JsonObject &config,
             };
             // First load the tileset image to get the number of available tiles.
             dbg( D_INFO ) << "Attempting to Load Tileset file " << tileset_image_path;
-            load_tileset( tileset_image_path, pump_events );
+            load_tileset( this_image->get(), tileset_image_path, pump_events );
             load_tilejson_from_file( tile_part_def );
             if( tile_part_def.has_member( "ascii" ) ) {
                 load_ascii( tile_part_def );
@@ -1335,6 +1822,8 @@ void cata_tiles::draw( const point &dest, const tripoint_bub_ms &center, int wid
         return;
     }
 
+    cache.upload_filtered_variants();
+
 #if defined(__ANDROID__)
     // Attempted bugfix for Google Play crash - prevent divide-by-zero if no tile
     // width/height specified
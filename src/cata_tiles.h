@@ -215,6 +215,12 @@ class tileset
         std::vector<texture> overexposed_tile_values;
         std::vector<texture> memory_tile_values;
 
+        struct pending_variant;
+        // Color filtered variants queued for or being filtered on worker threads, or
+        // waiting for the render thread to upload them. Queued jobs of dropped variants
+        // are skipped.
+        std::vector<std::shared_ptr<pending_variant>> pending_variants;
+
         std::unordered_set<std::string> duplicate_ids;
 
         std::unordered_map<std::string, tile_type> tile_ids;
@@ -223,14 +229,21 @@ class tileset
         std::array<std::unordered_map<std::string, season_tile_value>, season_type::NUM_SEASONS>
         tile_ids_by_season;
 
+        // Sprites of variants that haven't been uploaded yet are empty, the unfiltered
+        // sprite is drawn in their place meanwhile
         static const texture *get_if_available( const size_t index,
                                                 const decltype( shadow_tile_values ) &tiles ) {
-            return index < tiles.size() ? & tiles[index] : nullptr;
+            return index < tiles.size() && tiles[index].get_ptr() ? & tiles[index] : nullptr;
         }
 
+        /** Uploads the pending variants that are done filtering, on the render thread. */
+        void upload_filtered_variants();
+
         friend class tileset_cache;
 
     public:
+        tileset();
+        ~tileset();
 
         std::unordered_map<std::string, std::vector<layer_context_sprites>> item_layer_data;
         std::unordered_map<std::string, std::vector<layer_context_sprites>> field_layer_data;
@@ -313,6 +326,12 @@ class tileset_cache
         std::shared_ptr<const tileset> load_tileset( const std::string &tileset_id,
                 const SDL_Renderer_Ptr &renderer, bool precheck,
                 bool force, bool pump_events, bool terrain );
+        /**
+         * Color filtered sprites (shadow, night vision, memory...) are filtered on worker
+         * threads after load_tileset returns. This uploads the ones that are done, it must
+         * be called from the render thread before drawing.
+         */
+        void upload_filtered_variants();
     private:
         class loader;
 
@@ -346,7 +365,16 @@ class tileset_cache::loader
 
         void copy_surface_to_texture( const SDL_Surface_Ptr &surf, const point &offset,
                                       std::vector<texture> &target );
+        /** The sprites of every color variant, along with the filter each is made with. */
+        std::array<std::pair<std::vector<texture> *, std::string>, 5> color_variants();
+        /** Creates the textures of the unfiltered variants from one part of a tileset image. */
         void create_textures_from_tile_atlas( const SDL_Surface_Ptr &tile_atlas, const point &offset );
+        /**
+         * Queues the color filtered variants of a whole tileset image on the filter workers.
+         * Once filtered they're cut into textures along @p sub_rects, like the unfiltered ones.
+         */
+        void queue_filtered_variants( const SDL_Surface_Ptr &tile_atlas, const cata_path &img_path,
+                                      const std::vector<SDL_Rect> &sub_rects );
 
         void process_variations_after_loading( weighted_int_list<std::vector<int>> &v ) const;
 
@@ -374,6 +402,8 @@ class tileset_cache::loader
          * @throw std::exception If the image can not be loaded.
          */
         void load_tileset( const cata_path &path, bool pump_events );
+        /** Same as above, for an image that has already been decoded from @p path. */
+        void load_tileset( const SDL_Surface_Ptr &tile_atlas, const cata_path &path, bool pump_events );
         /**
          * Load tiles from json data.This expects a "tiles" array in
          * <B>config</B>. That array should contain all the tile definition that
@@ -787,6 +817,13 @@ class cata_tiles
         inline const tileset &get_tileset() {
             return *tileset_ptr;
         }
+        /**
+         * Changes every time a tileset gets (re)loaded, tile indices from before are stale then.
+         * Unique across all contexts.
+         */
+        int get_tileset_generation() const {
+            return tileset_generation;
+        }
 
     private:
         std::pair<std::string, bool> get_omt_id_rotation_and_subtile( const tripoint_abs_omt &omp,
@@ -822,6 +859,7 @@ class cata_tiles
         const GeometryRenderer_Ptr &geometry;
         tileset_cache &cache;
         std::shared_ptr<const tileset> tileset_ptr;
+        int tileset_generation = 0;
 
         // the scaled default sprite width and height. in non-isometric mode,
         // the basic tile width and height equal the default sprite width and
@@ -664,10 +664,10 @@ std::string obscure_message( const std::string &str, const std::function<char()>
 
 std::string serialize_wrapper( const std::function<void( JsonOut & )> &callback )
 {
-    std::ostringstream buffer;
+    std::string buffer;
     JsonOut jsout( buffer );
     callback( jsout );
-    return buffer.str();
+    return buffer;
 }
 
 void deserialize_wrapper( const std::function<void( const JsonValue & )> &callback,
@@ -1,6 +1,7 @@
 #include "creature_tracker.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <limits>
 #include <ostream>
 #include <string>
@@ -93,7 +94,8 @@ bool creature_tracker::add( const shared_ptr_fast<monster> &critter_ptr )
     }
 
     monsters_list.emplace_back( critter_ptr );
-    monsters_by_location[critter.pos_abs()] = critter_ptr;
+    monsters_list_order[critter_ptr.get()] = next_monsters_list_order++;
+    set_location( critter.pos_abs(), critter_ptr );
     return true;
 }
 
@@ -130,8 +132,8 @@ bool creature_tracker::update_pos( const monster &critter, const tripoint_abs_ms
         return ptr.get() == &critter;
     } );
     if( iter != monsters_list.end() ) {
-        monsters_by_location.erase( old_pos );
-        monsters_by_location[new_pos] = *iter;
+        erase_location( old_pos );
+        set_location( new_pos, *iter );
         return true;
     } else {
         // We're changing the x/y/z coordinates of a zombie that hasn't been added
@@ -148,7 +150,7 @@ void creature_tracker::remove_from_location_map( const monster &critter )
 {
     const auto pos_iter = monsters_by_location.find( critter.pos_abs() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
-        monsters_by_location.erase( pos_iter );
+        erase_location( critter.pos_abs() );
         return;
     }
 
@@ -159,10 +161,77 @@ void creature_tracker::remove_from_location_map( const monster &critter )
         return v.second.get() == &critter;
     } );
     if( iter != monsters_by_location.end() ) {
-        monsters_by_location.erase( iter );
+        erase_location( iter->first );
     }
 }
 
+void creature_tracker::set_location( const tripoint_abs_ms &pos,
+                                     const shared_ptr_fast<monster> &critter )
+{
+    erase_location( pos );
+    monsters_by_location[pos] = critter;
+    monsters_by_submap[project_to<coords::sm>( pos )].push_back( critter.get() );
+}
+
+void creature_tracker::erase_location( const tripoint_abs_ms &pos )
+{
+    const auto pos_iter = monsters_by_location.find( pos );
+    if( pos_iter == monsters_by_location.end() ) {
+        return;
+    }
+    const auto sm_iter = monsters_by_submap.find( project_to<coords::sm>( pos ) );
+    if( sm_iter != monsters_by_submap.end() ) {
+        std::vector<monster *> &on_submap = sm_iter->second;
+        const auto iter = std::find( on_submap.begin(), on_submap.end(), pos_iter->second.get() );
+        if( iter != on_submap.end() ) {
+            *iter = on_submap.back();
+            on_submap.pop_back();
+        }
+        if( on_submap.empty() ) {
+            monsters_by_submap.erase( sm_iter );
+        }
+    }
+    monsters_by_location.erase( pos_iter );
+}
+
+void creature_tracker::clear_locations()
+{
+    monsters_by_location.clear();
+    monsters_by_submap.clear();
+}
+
+std::vector<monster *> creature_tracker::monsters_around( const tripoint_abs_ms &center,
+        int radius, int z_radius ) const
+{
+    std::vector<monster *> ret;
+    const tripoint_abs_sm min_sm = project_to<coords::sm>( center - tripoint( radius, radius,
+                                   z_radius ) );
+    const tripoint_abs_sm max_sm = project_to<coords::sm>( center + tripoint( radius, radius,
+                                   z_radius ) );
+    for( int z = min_sm.z(); z <= max_sm.z(); ++z ) {
+        for( int x = min_sm.x(); x <= max_sm.x(); ++x ) {
+            for( int y = min_sm.y(); y <= max_sm.y(); ++y ) {
+                const auto iter = monsters_by_submap.find( tripoint_abs_sm( x, y, z ) );
+                if( iter == monsters_by_submap.end() ) {
+                    continue;
+                }
+                for( monster *critter : iter->second ) {
+                    const tripoint_abs_ms pos = critter->pos_abs();
+                    if( !critter->is_dead() && std::abs( pos.x() - center.x() ) <= radius &&
+                        std::abs( pos.y() - center.y() ) <= radius ) {
+                        ret.push_back( critter );
+                    }
+                }
+            }
+        }
+    }
+    // The submaps are visited in no particular order, put the monsters back into list order
+    std::sort( ret.begin(), ret.end(), [this]( const monster * lhs, const monster * rhs ) {
+        return monsters_list_order.at( lhs ) < monsters_list_order.at( rhs );
+    } );
+    return ret;
+}
+
 void creature_tracker::remove( const monster &critter )
 {
     const auto iter = std::find_if( monsters_list.begin(), monsters_list.end(),
@@ -175,6 +244,7 @@ void creature_tracker::remove( const monster &critter )
     }
 
     remove_from_location_map( critter );
+    monsters_list_order.erase( &critter );
     removed_this_turn_.emplace( *iter );
     monsters_list.erase( iter );
 }
@@ -182,7 +252,8 @@ void creature_tracker::remove( const monster &critter )
 void creature_tracker::clear()
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    monsters_list_order.clear();
+    clear_locations();
     removed_this_turn_.clear();
     creatures_by_zone_and_faction_.clear();
     invalidate_reachability_cache();
@@ -190,9 +261,9 @@ void creature_tracker::clear()
 
 void creature_tracker::rebuild_cache()
 {
-    monsters_by_location.clear();
+    clear_locations();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
-        monsters_by_location[mon_ptr->pos_abs()] = mon_ptr;
+        set_location( mon_ptr->pos_abs(), mon_ptr );
     }
 }
 
@@ -235,14 +306,14 @@ void creature_tracker::swap_positions( monster &first, monster &second )
     shared_ptr_fast<monster> first_ptr;
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
-        monsters_by_location.erase( first_iter );
     }
 
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
-        monsters_by_location.erase( second_iter );
     }
+    erase_location( first.pos_abs() );
+    erase_location( second.pos_abs() );
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
     const tripoint_abs_ms temp = second.pos_abs();
@@ -251,10 +322,10 @@ void creature_tracker::swap_positions( monster &first, monster &second )
 
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
-        monsters_by_location[first.pos_abs()] = first_ptr;
+        set_location( first.pos_abs(), first_ptr );
     }
     if( second_ptr ) {
-        monsters_by_location[second.pos_abs()] = second_ptr;
+        set_location( second.pos_abs(), second_ptr );
     }
 }
 
@@ -290,6 +361,7 @@ void creature_tracker::remove_dead()
         monster *const critter = iter->get();
         if( critter->is_dead() ) {
             remove_from_location_map( *critter );
+            monsters_list_order.erase( critter );
             iter = monsters_list.erase( iter );
         } else {
             ++iter;
@@ -3,6 +3,7 @@
 #define CATA_SRC_CREATURE_TRACKER_H
 
 #include <cstddef>
+#include <cstdint>
 #include <list>
 #include <memory>
 #include <unordered_map>
@@ -123,6 +124,16 @@ class creature_tracker
             return monsters_list;
         }
 
+        /**
+         * Returns the monsters at most @p radius away from @p center along x and y, and at
+         * most @p z_radius along z. Only the submaps in that box are looked at, instead of all
+         * monsters. Callers that want a round distance or line of sight check that themselves.
+         * Dead monsters are ignored and not returned. The monsters come in the same order as in
+         * @ref monsters_list, so picking from them behaves like picking from that list.
+         */
+        std::vector<monster *> monsters_around( const tripoint_abs_ms &center, int radius,
+                                                int z_radius = 0 ) const;
+
         void serialize( JsonOut &jsout ) const;
         void deserialize( const JsonArray &ja );
 
@@ -137,6 +148,15 @@ class creature_tracker
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
 
+        /**
+         * Put the monster into @ref monsters_by_location and @ref monsters_by_submap, replacing
+         * whatever was at @p pos before.
+         */
+        void set_location( const tripoint_abs_ms &pos, const shared_ptr_fast<monster> &critter );
+        /** Remove whatever monster is at @p pos from @ref monsters_by_location and @ref monsters_by_submap */
+        void erase_location( const tripoint_abs_ms &pos );
+        void clear_locations();
+
         void flood_fill_zone( const Creature &origin );
 
         void rebuild_cache();
@@ -148,6 +168,13 @@ class creature_tracker
         std::vector<shared_ptr_fast<monster>> monsters_list;
         // NOLINTNEXTLINE(cata-serialize)
         std::unordered_map<tripoint_abs_ms, shared_ptr_fast<monster>> monsters_by_location;
+        // The same monsters again, grouped by the submap they are on, for finding those nearby
+        // NOLINTNEXTLINE(cata-serialize)
+        std::unordered_map<tripoint_abs_sm, std::vector<monster *>> monsters_by_submap;
+        // When each monster was added, which sorts them the same as @ref monsters_list
+        // NOLINTNEXTLINE(cata-serialize)
+        std::unordered_map<const monster *, std::uint64_t> monsters_list_order;
+        std::uint64_t next_monsters_list_order = 0; // NOLINT(cata-serialize)
 
         /**
          * Creatures that get removed via @ref remove are stored here until the end of the turn.
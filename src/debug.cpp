@@ -104,6 +104,8 @@ static int debugClass = D_MAIN;
 
 /** Set to true when any error is logged. */
 static bool error_observed = false;
+/** Number of debugmsg calls so far, see debugmsg_count. */
+static int debugmsg_calls = 0;
 
 /** If true, debug messages will be captured,
  * used to test debugmsg calls in the unit tests
@@ -210,6 +212,11 @@ bool debug_has_error_been_observed()
     return error_observed;
 }
 
+int debugmsg_count()
+{
+    return debugmsg_calls;
+}
+
 bool debug_mode = false;
 
 namespace debugmode
@@ -513,6 +520,7 @@ void realDebugmsg( const char *filename, const char *line, const char *funcname,
     cata_assert( line != nullptr );
     cata_assert( funcname != nullptr );
 
+    debugmsg_calls++;
     if( capturing ) {
         captured += text;
     } else {
@@ -209,6 +209,11 @@ void limitDebugClass( int );
  */
 bool debug_has_error_been_observed();
 
+/**
+ * @return the number of debugmsg calls made in this run, including captured ones.
+ */
+int debugmsg_count();
+
 /**
  * Capturing debug messages during func execution,
  * used to test debugmsg calls in the unit tests
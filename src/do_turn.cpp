@@ -48,6 +48,7 @@
 #include "memorial_logger.h"
 #include "messages.h"
 #include "mission.h"
+#include "monfaction.h"
 #include "monster.h"
 #include "mtype.h"
 #include "music.h"
@@ -266,12 +267,81 @@ void handle_key_blocking_activity()
 
 namespace
 {
+// Whether monster::plan() of the first monster looks out for the second one
+bool watches( const monster &critter, const monster &other )
+{
+    if( critter.friendly != 0 ) {
+        return other.friendly == 0;
+    }
+    if( critter.faction == other.faction ) {
+        return critter.has_flag( mon_flag_SWARMS ) || critter.has_flag( mon_flag_GROUP_MORALE );
+    }
+    const mf_attitude faction_att = critter.faction->attitude( other.faction );
+    return faction_att != MFA_NEUTRAL && faction_att != MFA_FRIENDLY;
+}
+
+} // namespace
+
+std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>> monster_sight_lines( const map &m )
+{
+    struct watcher {
+        monster *critter;
+        tripoint_bub_ms pos;
+        int range;
+    };
+    std::vector<watcher> active;
+    for( monster &critter : g->all_monsters() ) {
+        if( m.inbounds( critter.pos_abs() ) && !critter.is_dead() &&
+            !critter.has_effect( effect_ridden ) ) {
+            active.push_back( { &critter, critter.pos_bub( m ),
+                                std::max( critter.sight_range( default_daylight_level() ),
+                                          critter.sight_range( 0 ) ) } );
+        }
+    }
+
+    std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>> lines;
+    const auto look_at = [&]( const watcher &from, const tripoint_bub_ms &to ) {
+        const int dist = rl_dist( from.pos, to );
+        // Adjacent creatures are seen without casting a line
+        if( to.z() == from.pos.z() && dist > 1 && dist <= from.range ) {
+            lines.emplace_back( from.pos, to );
+        }
+    };
+    for( size_t i = 0; i < active.size(); ++i ) {
+        const watcher &critter = active[i];
+        // sees() remembers one line for both directions, and bresenham lines aren't symmetric.
+        // So a line is cast from whoever looks along it first, as sees() would: the monster
+        // earlier in the turn order if it watches the other one at all.
+        for( size_t j = i + 1; j < active.size(); ++j ) {
+            const watcher &other = active[j];
+            if( watches( *critter.critter, *other.critter ) ) {
+                look_at( critter, other.pos );
+            } else if( watches( *other.critter, *critter.critter ) ) {
+                look_at( other, critter.pos );
+            }
+        }
+        for( const npc &guy : g->all_npcs() ) {
+            const mf_attitude faction_att = critter.critter->faction->attitude(
+                                                guy.get_monster_faction() );
+            if( faction_att != MFA_NEUTRAL && faction_att != MFA_FRIENDLY ) {
+                look_at( critter, guy.pos_bub( m ) );
+            }
+        }
+    }
+    return lines;
+}
+
+namespace
+{
+
 void monmove()
 {
     g->cleanup_dead();
     map &m = get_map();
     avatar &u = get_avatar();
 
+    m.cache_sight_lines( monster_sight_lines( m ) );
+
     for( monster &critter : g->all_monsters() ) {
         if( !m.inbounds( critter.pos_abs() ) ) {
             continue;
@@ -2,8 +2,22 @@
 #ifndef CATA_SRC_DO_TURN_H
 #define CATA_SRC_DO_TURN_H
 
+#include <utility>
+#include <vector>
+
+#include "coordinates.h"
+
+class map;
+
 /** MAIN GAME LOOP. Returns true if game is over (death, saved, quit, etc.). */
 bool do_turn();
 void handle_key_blocking_activity();
 
+/**
+ * The lines of sight the monsters will look along when planning their moves this turn. Those
+ * only read the map, so they are cast up front on all cores instead of one by one in the
+ * middle of the monsters acting. Each line starts at the monster that looks along it first.
+ */
+std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>> monster_sight_lines( const map &m );
+
 #endif // CATA_SRC_DO_TURN_H
@@ -31,7 +31,7 @@ void ViewEntry::rebuild_sprite_cache(const Project& project) const
         const Piece* ptr_raw = get_first_piece_of_type(PieceType::AltTerrain);
         const PieceAltTerrain* ptr = dynamic_cast<const PieceAltTerrain*>(ptr_raw);
         if (ptr) {
-            auto list = ptr->list;
+            const auto &list = ptr->list;
             if (!list.entries.empty() && !list.entries[0].val.is_null()) {
                 sprite_cache_ter = SpriteRef(list.entries[0].val.data);
             }
@@ -42,7 +42,7 @@ void ViewEntry::rebuild_sprite_cache(const Project& project) const
         const Piece* ptr_raw = get_first_piece_of_type(PieceType::AltFurniture);
         const PieceAltFurniture* ptr = dynamic_cast<const PieceAltFurniture*>(ptr_raw);
         if (ptr) {
-            auto list = ptr->list;
+            const auto &list = ptr->list;
             if (!list.entries.empty() && !list.entries[0].val.is_null()) {
                 sprite_cache_furn = SpriteRef(list.entries[0].val.data);
             }
@@ -0,0 +1,287 @@
+#include "mapgen_sampler.h"
+
+#include "project.h"
+#include "project_export.h"
+
+#include "avatar.h"
+#include "calendar.h"
+#include "cata_scope_helpers.h"
+#include "cata_utility.h"
+#include "coordinates.h"
+#include "item.h"
+#include "json.h"
+#include "json_loader.h"
+#include "map.h"
+#include "mapgen.h"
+#include "mapgendata.h"
+#include "overmapbuffer.h"
+#include "rng.h"
+
+#include <memory>
+#include <optional>
+#include <set>
+#include <utility>
+
+static const oter_str_id oter_field( "field" );
+
+namespace editor
+{
+
+namespace
+{
+
+/**
+ * Mapgen function(s) built from the exported json of a single project mapgen.
+ * Oter mapgens have one function per cell of their om_terrain matrix.
+ */
+struct SampledMapgen {
+    const Mapgen *source = nullptr;
+    point cells = point( 1, 1 );
+    std::vector<std::shared_ptr<mapgen_function>> oter;
+    std::shared_ptr<mapgen_function_json_nested> nested;
+    std::shared_ptr<update_mapgen_function_json> update;
+};
+
+/**
+ * Temporarily registers project nested mapgens under their ids, so nested chunks
+ * placed by other project mapgens resolve to what's being edited.
+ */
+class NestedMapgenOverride
+{
+    public:
+        NestedMapgenOverride() = default;
+        NestedMapgenOverride( const NestedMapgenOverride & ) = delete;
+        NestedMapgenOverride &operator=( const NestedMapgenOverride & ) = delete;
+
+        ~NestedMapgenOverride() {
+            for( auto &it : saved ) {
+                if( it.second ) {
+                    nested_mapgens[it.first] = std::move( *it.second );
+                } else {
+                    nested_mapgens.erase( it.first );
+                }
+            }
+        }
+
+        void add( const nested_mapgen_id &id, const std::shared_ptr<mapgen_function_json_nested> &f,
+                  int weight ) {
+            if( saved.count( id ) == 0 ) {
+                auto it = nested_mapgens.find( id );
+                if( it != nested_mapgens.end() ) {
+                    saved.emplace( id, std::move( it->second ) );
+                } else {
+                    saved.emplace( id, std::nullopt );
+                }
+                nested_mapgens[id] = nested_mapgen();
+            }
+            nested_mapgens[id].add( f, weight );
+        }
+
+    private:
+        std::map<nested_mapgen_id, std::optional<nested_mapgen>> saved;
+};
+
+// Far enough from the avatar for the scratch submaps to stay outside of the reality bubble
+tripoint_abs_omt sample_location()
+{
+    return project_to<coords::omt>( get_avatar().pos_abs() ) + tripoint( 10, 10, 0 );
+}
+
+SampledMapgen load_sampled_mapgen( const Mapgen &mapgen, const JsonObject &jo )
+{
+    SampledMapgen ret;
+    ret.source = &mapgen;
+    const std::string name = mapgen.display_name();
+    JsonObject jo_object = jo.get_object( "object" );
+    jo_object.allow_omitted_members();
+
+    if( mapgen.mtype == MapgenType::Oter ) {
+        if( mapgen.oter.matrix_mode ) {
+            ret.cells = mapgen.oter.om_terrain_matrix.get_size();
+        }
+        const point_rel_omt total( ret.cells );
+        for( int y = 0; y < ret.cells.y; y++ ) {
+            for( int x = 0; x < ret.cells.x; x++ ) {
+                std::shared_ptr<mapgen_function> f =
+                    load_mapgen_function( jo, name, point_rel_omt( x, y ), total, false );
+                if( f ) {
+                    f->setup();
+                    f->finalize_parameters();
+                }
+                ret.oter.push_back( f );
+            }
+        }
+    } else if( mapgen.mtype == MapgenType::Nested ) {
+        ret.nested = load_nested_mapgen_function( jo_object, "nested mapgen " + name );
+        ret.nested->setup();
+        ret.nested->finalize_parameters();
+    } else {
+        ret.update = load_update_mapgen_function( jo_object, "update mapgen " + name );
+        ret.update->setup();
+        ret.update->finalize_parameters();
+    }
+    return ret;
+}
+
+void tally_sample( MapgenHeatmap &heatmap, map &m, const point &cell, int z )
+{
+    const point origin( cell.x * SEEX * 2, cell.y * SEEY * 2 );
+    for( int y = 0; y < SEEY * 2; y++ ) {
+        for( int x = 0; x < SEEX * 2; x++ ) {
+            const tripoint_bub_ms p( x, y, z );
+            const size_t idx = ( origin.y + y ) * heatmap.size.x + origin.x + x;
+            const size_t total = heatmap.size.x * heatmap.size.y;
+            const auto count = [&]( std::map<std::string, std::vector<int>> &list, const std::string & id ) {
+                std::vector<int> &counts = list[id];
+                counts.resize( total, 0 );
+                counts[idx]++;
+            };
+            count( heatmap.ter, m.ter( p ).id().str() );
+            if( m.has_furn( p ) ) {
+                count( heatmap.furn, m.furn( p ).id().str() );
+            }
+            std::set<std::string> items_here;
+            for( const item &it : m.i_at( p ) ) {
+                items_here.insert( it.typeId().str() );
+            }
+            for( const std::string &id : items_here ) {
+                count( heatmap.items, id );
+            }
+        }
+    }
+}
+
+MapgenHeatmap sample_mapgen( const SampledMapgen &sm, int num_samples, unsigned int seed )
+{
+    MapgenHeatmap ret;
+    ret.mapgen_name = sm.source->display_name();
+    ret.size = point( sm.cells.x * SEEX * 2, sm.cells.y * SEEY * 2 );
+    ret.num_samples = num_samples;
+
+    // Sampling must not leave traces in the game: the overmap tile it generates on and the
+    // rng it reseeds for every sample are put back as they were
+    const tripoint_abs_omt pos = sample_location();
+    const oter_id previous_ter = overmap_buffer.ter( pos );
+    const cata_default_random_engine previous_rng = rng_get_engine();
+    on_out_of_scope restore( [&]() {
+        overmap_buffer.ter_set( pos, previous_ter );
+        rng_get_engine() = previous_rng;
+    } );
+    // A plain field never gets rotated, so the samples come out as drawn
+    overmap_buffer.ter_set( pos, oter_field.id() );
+
+    for( int i = 0; i < num_samples; i++ ) {
+        for( int y = 0; y < sm.cells.y; y++ ) {
+            for( int x = 0; x < sm.cells.x; x++ ) {
+                rng_set_engine_seed( seed + i * sm.cells.x * sm.cells.y + y * sm.cells.x + x );
+                smallmap tm;
+                tm.generate( pos, calendar::turn, false );
+                mapgendata md( pos, *tm.cast_to_map(), 0.0f, calendar::turn, nullptr );
+                if( !sm.oter.empty() ) {
+                    const std::shared_ptr<mapgen_function> &f = sm.oter[y * sm.cells.x + x];
+                    if( f ) {
+                        f->generate( md );
+                    }
+                } else if( sm.nested ) {
+                    sm.nested->nest( md, tripoint_rel_ms::zero, "mapgen sample" );
+                } else if( sm.update ) {
+                    sm.update->update_map( md );
+                }
+                tally_sample( ret, *tm.cast_to_map(), point( x, y ), pos.z() );
+                tm.delete_unmerged_submaps();
+            }
+        }
+    }
+    return ret;
+}
+
+} // namespace
+
+void MapgenHeatmap::serialize( JsonOut &jsout ) const
+{
+    const auto write_list = [&]( const std::string & name,
+    const std::map<std::string, std::vector<int>> &list ) {
+        jsout.member( name );
+        jsout.start_object();
+        for( const auto &it : list ) {
+            jsout.member( it.first, it.second );
+        }
+        jsout.end_object();
+    };
+
+    jsout.start_object();
+    jsout.member( "mapgen", mapgen_name );
+    jsout.member( "size" );
+    jsout.start_array();
+    jsout.write( size.x );
+    jsout.write( size.y );
+    jsout.end_array();
+    jsout.member( "samples", num_samples );
+    write_list( "terrain", ter );
+    write_list( "furniture", furn );
+    write_list( "items", items );
+    jsout.end_object();
+}
+
+std::vector<MapgenHeatmap> sample_project_mapgens( const Project &project, int num_samples,
+        unsigned int seed )
+{
+    const std::string exported = editor_export::to_string( project );
+    const JsonValue jsin = json_loader::from_string( exported );
+
+    // Palettes go first, then one object per project mapgen in the same order.  Declared
+    // before the sampled mapgens, so the palettes they were set up with outlive them.
+    mapgen_palette_override palette_override;
+    std::vector<JsonObject> mapgen_objects;
+    for( JsonObject jo : jsin.get_array() ) {
+        jo.allow_omitted_members();
+        if( jo.get_string( "type" ) == "palette" ) {
+            palette_override.load( jo, "editor" );
+        } else {
+            mapgen_objects.push_back( jo );
+        }
+    }
+    if( mapgen_objects.size() != project.mapgens.size() ) {
+        debugmsg( "Exported %d mapgens, but the project has %d.", mapgen_objects.size(),
+                  project.mapgens.size() );
+        return {};
+    }
+
+    std::vector<SampledMapgen> sampled;
+    NestedMapgenOverride nested_override;
+    for( size_t i = 0; i < mapgen_objects.size(); i++ ) {
+        const Mapgen &mapgen = project.mapgens[i];
+        try {
+            sampled.push_back( load_sampled_mapgen( mapgen, mapgen_objects[i] ) );
+        } catch( const std::exception &err ) {
+            debugmsg( "Failed to load mapgen %s for sampling: %s", mapgen.display_name(), err.what() );
+            continue;
+        }
+        if( sampled.back().nested ) {
+            nested_override.add( nested_mapgen_id( mapgen.nested.nested_mapgen_id ),
+                                 sampled.back().nested,
+                                 mapgen_objects[i].get_int( "weight", 1000 ) );
+        }
+    }
+
+    std::vector<MapgenHeatmap> ret;
+    ret.reserve( sampled.size() );
+    for( const SampledMapgen &sm : sampled ) {
+        ret.push_back( sample_mapgen( sm, num_samples, seed ) );
+    }
+    return ret;
+}
+
+void write_mapgen_heatmaps( const std::string &path, const std::vector<MapgenHeatmap> &heatmaps )
+{
+    write_to_file( path, [&]( std::ostream & fout ) {
+        JsonOut jsout( fout );
+        jsout.start_array();
+        for( const MapgenHeatmap &heatmap : heatmaps ) {
+            heatmap.serialize( jsout );
+        }
+        jsout.end_array();
+    } );
+}
+
+} // namespace editor
@@ -0,0 +1,54 @@
+#ifndef CATA_SRC_EDITOR_MAPGEN_SAMPLER_H
+#define CATA_SRC_EDITOR_MAPGEN_SAMPLER_H
+
+#include "point.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class JsonOut;
+
+namespace editor
+{
+struct Project;
+
+/**
+ * Per-tile frequencies of what the real mapgen placed over a number of generated samples.
+ * Each list holds, for every tile in row-major order, the amount of samples that had the id there.
+ */
+struct MapgenHeatmap {
+    std::string mapgen_name;
+    point size;
+    int num_samples = 0;
+    std::map<std::string, std::vector<int>> ter;
+    std::map<std::string, std::vector<int>> furn;
+    std::map<std::string, std::vector<int>> items;
+
+    void serialize( JsonOut &jsout ) const;
+};
+
+/**
+ * Export the project in memory, load its mapgens into the mapgen factory and generate
+ * each of them @p num_samples times with consecutive rng seeds starting at @p seed.
+ *
+ * Samples are generated on scratch submaps outside of the reality bubble that are thrown
+ * away afterwards, on the avatar's z-level. Oter mapgens replace a plain field, update and
+ * nested mapgens are applied on top of it. Project palettes and nested mapgens stand in for
+ * the game's ones with the same ids only while sampling, and the overmap tile sampled on
+ * and the rng state are restored afterwards.
+ *
+ * Samples are generated one after another: mapgen goes through the global map buffer,
+ * overmap buffer and rng, none of which can be shared between threads.
+ *
+ * This needs the world the editor sets up, so --sample-mapgens runs from the editor's UI
+ * loop once the project is open, and quits the game once the heatmaps are written.
+ */
+std::vector<MapgenHeatmap> sample_project_mapgens( const Project &project, int num_samples,
+        unsigned int seed );
+
+void write_mapgen_heatmaps( const std::string &path, const std::vector<MapgenHeatmap> &heatmaps );
+
+} // namespace editor
+
+#endif // CATA_SRC_EDITOR_MAPGEN_SAMPLER_H
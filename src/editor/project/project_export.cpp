@@ -1375,7 +1375,7 @@ std::string to_string( const editor::Project &project )
 std::string format_string( const std::string &js )
 {
     std::stringstream in;
-    std::stringstream out;
+    std::string out;
 
     in << js;
 
@@ -1384,9 +1384,9 @@ std::string format_string( const std::string &js )
 
     formatter::format( jsin, jsout );
 
-    out << std::endl;
+    out += '\n';
 
-    return out.str();
+    return out;
 }
 
 } // namespace editor_export
@@ -72,6 +72,9 @@ void update_app_state( App &app )
         }
         app.title_state->ret.reset();
     } else if( app.editor_state && !app.editor_state->control->is_editor_running ) {
+        if( app.editor_state->control->exit_to_desktop ) {
+            app.run_state.do_exit_to_dektop = true;
+        }
         app.editor_state.reset();
         set_default_ini_path();
     }
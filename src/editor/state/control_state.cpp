@@ -3,6 +3,7 @@
 #include <imgui/imgui.h>
 #include "tool/cursor.h"
 #include "tool/selection.h"
+#include "view/view_canvas.h"
 
 #include <memory>
 
@@ -5,12 +5,15 @@
 #include "tool/tool.h"
 #include "widget/editable_id.h"
 #include "mapgen/canvas_snippet.h"
+#include "pimpl.h"
 
 #include <memory>
 #include <unordered_map>
 
 namespace editor
 {
+struct NestPreviewCache;
+
 enum class QuickAddMode {
     Ter,
     Furn,
@@ -70,6 +73,7 @@ struct ControlState {
         ControlState &operator=( ControlState && );
 
         bool is_editor_running = true;
+        bool exit_to_desktop = false;           // Quit the game along with the editor
         bool want_close = false;                // User wants to close the project
         bool want_save = false;                 // User wants to save
         bool want_save_as = false;              // User wants to save as
@@ -87,6 +91,7 @@ struct ControlState {
 
         QuickPaletteAddState quick_add_state;
         SnippetsState snippets;
+        pimpl<NestPreviewCache> nest_previews;
         UUID import_all_nests_of = UUID_INVALID;
 
         void show_warning_popup( const std::string &data );
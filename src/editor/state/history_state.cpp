@@ -93,6 +93,7 @@ void handle_snapshot_change( HistoryState &state )
         assert( it != state.snapshots.cend() );
         state.current_snapshot = it->make_copy();
         state.switch_to_snapshot.reset();
+        state.revision++;
     } else if( state.project_has_changes ) {
         state.project_has_changes = false;
 
@@ -170,6 +171,7 @@ void HistoryState::mark_changed( const char *id )
     }
     project_has_changes = true;
     edit_counter++;
+    revision++;
 }
 
 bool HistoryState::has_unsaved_changes() const
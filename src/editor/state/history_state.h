@@ -92,6 +92,8 @@ struct HistoryState {
     std::optional<SnapshotNumber> last_exported_snapshot;
     std::optional<SnapshotNumber> last_autosaved_snapshot;
     int edit_counter = 0;
+    // Changes whenever the current project does, including undo/redo
+    int revision = 0;
 };
 
 /**
@@ -6,6 +6,7 @@
 #include "history_state.h"
 #include <imgui/imgui.h>
 #include "path_info.h"
+#include "project/mapgen_sampler.h"
 #include "project/project.h"
 #include "project/project_export.h"
 #include "state.h"
@@ -178,6 +179,20 @@ void handle_project_exporting( State &state )
     }
 }
 
+void handle_project_sampling( State &state )
+{
+    if( !g->sample_editor_project_on_start ) {
+        return;
+    }
+    const std::string path = *g->sample_editor_project_on_start;
+    g->sample_editor_project_on_start.reset();
+    write_mapgen_heatmaps( path, sample_project_mapgens( state.project(),
+                           g->sample_editor_project_count, 1 ) );
+    // A batch job, there's nothing left to do once the heatmaps are written
+    state.control->is_editor_running = false;
+    state.control->exit_to_desktop = true;
+}
+
 void handle_project_exiting( State &state )
 {
     ControlState &control = *state.control;
@@ -25,6 +25,7 @@ struct SaveExportState {
 void handle_project_autosave( State &state );
 void handle_project_saving( State &state );
 void handle_project_exporting( State &state );
+void handle_project_sampling( State &state );
 void handle_project_exiting( State &state );
 void show_autosave_settings( UiState &ui, bool &show );
 
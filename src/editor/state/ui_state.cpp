@@ -206,6 +206,7 @@ void run_ui_for_state( State &state )
     handle_project_autosave( state );
     handle_project_saving( state );
     handle_project_exporting( state );
+    handle_project_sampling( state );
     handle_project_exiting( state );
 
     Project &proj = state.project();
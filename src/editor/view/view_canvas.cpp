@@ -1,6 +1,7 @@
 #include "view_canvas.h"
 
 #include "camera.h"
+#include "cata_tiles.h"
 #include "common/algo.h"
 #include "common/canvas_2d.h"
 #include "common/color.h"
@@ -9,6 +10,8 @@
 #include "common/uuid.h"
 #include "coordinates.h"
 #include "drawing.h"
+#include "hash_utils.h"
+#include "json.h"
 #include "mapgen/canvas_snippet.h"
 #include "mapgen/mapgen.h"
 #include "mapgen/palette.h"
@@ -16,21 +19,27 @@
 #include "mouse.h"
 #include "project/project.h"
 #include "state/control_state.h"
+#include "state/history_state.h"
 #include "mapgen/selection_mask.h"
 #include "state/state.h"
 #include "state/tools_state.h"
 #include "state/ui_state.h"
 #include "tool/tool.h"
+#include "sdltiles.h"
 #include "uistate.h"
 #include "widget/widgets.h"
 #include "mapgen/palette_view.h"
 #include "mapgen/piece_impl.h"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <optional>
 #include <set>
 #include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <imgui/imgui.h>
 
@@ -214,6 +223,100 @@ ViewCanvas::ViewCanvas(State& state, Mapgen& mapgen) : mapgen(mapgen), project(s
     }
 }
 
+using PaletteHashes = std::unordered_map<const Palette*, size_t>;
+
+static void hash_palette_recursive(const Project& project, const Palette* pal, size_t& seed,
+    PaletteHashes& palette_hashes, std::unordered_set<const Palette*>& visited)
+{
+    cata::hash_combine(seed, pal);
+    if (!pal || !visited.insert(pal).second) {
+        return;
+    }
+    auto it = palette_hashes.find(pal);
+    if (it == palette_hashes.end()) {
+        std::string json;
+        JsonOut jsout(json);
+        pal->serialize(jsout);
+        it = palette_hashes.emplace(pal, std::hash<std::string>()(json)).first;
+    }
+    cata::hash_combine(seed, it->second);
+    for (const PaletteAncestorSwitch& sw : pal->ancestors.list) {
+        for (const std::string& opt : sw.options) {
+            hash_palette_recursive(project, project.find_palette_by_string(opt), seed, palette_hashes, visited);
+        }
+    }
+}
+
+// Hash of everything a preview of the mapgen references: the mapgen itself and
+// all palettes it may draw on, along with where they live in the project.
+// Palettes shared between nests are only serialized once per pass.
+static size_t nest_preview_hash(const Project& project, const Mapgen& mapgen, PaletteHashes& palette_hashes)
+{
+    std::string json;
+    JsonOut jsout(json);
+    mapgen.serialize(jsout);
+    size_t seed = std::hash<std::string>()(json);
+    cata::hash_combine(seed, &mapgen);
+    std::unordered_set<const Palette*> visited;
+    hash_palette_recursive(project, project.get_palette(mapgen.base.palette), seed, palette_hashes, visited);
+    return seed;
+}
+
+ViewCanvas& NestPreviewCache::get(State& state, Mapgen& mapgen)
+{
+    const Project* current_project = &state.project();
+    const int current_revision = state.history->revision;
+    const int current_tileset_generation = tilecontext->get_tileset_generation();
+    if (project != current_project || tileset_generation != current_tileset_generation) {
+        entries.clear();
+        project = current_project;
+        tileset_generation = current_tileset_generation;
+    }
+    PaletteHashes palette_hashes;
+    if (revision != current_revision) {
+        revision = current_revision;
+        for (auto it = entries.begin(); it != entries.end();) {
+            const Mapgen* nested = current_project->get_mapgen(it->first);
+            if (!nested || nest_preview_hash(*current_project, *nested, palette_hashes) != it->second.content_hash) {
+                it = entries.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    const int frame = ImGui::GetFrameCount();
+    auto it = entries.find(mapgen.uuid);
+    if (it == entries.end()) {
+        if (entries.size() >= max_entries) {
+            auto oldest = std::min_element(entries.begin(), entries.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.second.last_used < rhs.second.last_used;
+            });
+            // Previews handed out this frame are still being drawn
+            if (oldest->second.last_used != frame) {
+                entries.erase(oldest);
+            }
+        }
+        it = entries.emplace(mapgen.uuid, Entry()).first;
+    }
+    Entry& entry = it->second;
+    entry.last_used = frame;
+
+    const ViewPaletteTreeState& tree_state = state.ui->view_palette_tree_states[mapgen.base.palette];
+    // Snippets get moved around without marking the project as changed
+    const bool has_snippet = state.control->snippets.get_snippet(mapgen.uuid) != nullptr;
+    if (!entry.canvas || has_snippet || entry.tree_state.selected_opts != tree_state.selected_opts) {
+        entry.canvas = std::make_unique<ViewCanvas>(state, mapgen);
+        entry.canvas->child_mode = true;
+        // Building the canvas may have clamped the selected options, so copy them afterwards
+        entry.tree_state = state.ui->view_palette_tree_states[mapgen.base.palette];
+        entry.content_hash = nest_preview_hash(*current_project, mapgen, palette_hashes);
+    }
+    return *entry.canvas;
+}
+
 void ViewCanvas::draw_background(ImDrawList* draw_list, Camera& cam, UiState&ui) const {
     fill_region(
         draw_list,
@@ -772,14 +875,12 @@ void show_editor_view( State &state, Mapgen *mapgen_ptr )
         }
     }
 
-    std::unordered_map<Mapgen*, std::unique_ptr<ViewCanvas>> nest_canvases;
+    std::unordered_map<Mapgen*, ViewCanvas*> nest_canvases;
     for (ViewCanvasNest& it : vc.nests) {
         if (nest_canvases.find(it.mapgen) != nest_canvases.end()) {
             continue;
         }
-        ViewCanvas nest_canvas(state, *it.mapgen);
-        nest_canvas.child_mode = true;
-        nest_canvases.emplace( it.mapgen, std::make_unique<ViewCanvas>( std::move(nest_canvas)));
+        nest_canvases.emplace(it.mapgen, &state.control->nest_previews->get(state, *it.mapgen));
     }
 
     vc.draw_background(draw_list, cam, *state.ui);
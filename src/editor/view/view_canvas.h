@@ -5,6 +5,10 @@
 #include "common/canvas_2d.h"
 #include "common/sprite_ref.h"
 #include "mapgen/palette_view.h"
+#include "state/ui_state.h"
+
+#include <memory>
+#include <unordered_map>
 
 struct ImDrawList;
 
@@ -92,6 +96,39 @@ struct ViewCanvas {
     MapKey get_tooltip_highlighted_key(Camera& cam) const;
 };
 
+/**
+ * Previews of nested mapgens placed on a canvas, kept across frames.
+ *
+ * Building a preview resolves the nested mapgen's palettes and sprites, which
+ * is too slow to redo every frame for each nest. Previews hold references into
+ * the project, so each one remembers a hash of the nested mapgen and of the
+ * palettes it draws on, addresses included. After an edit only the previews
+ * whose hash no longer matches are dropped. All of them are dropped when
+ * switching projects or reloading the tileset. A single preview is rebuilt when
+ * a different set of palette options was picked for display. Past max_entries
+ * previews, the one drawn least recently is dropped, unless all of them are
+ * drawn this frame.
+ */
+struct NestPreviewCache {
+    static constexpr size_t max_entries = 64;
+
+    ViewCanvas &get( State &state, Mapgen &mapgen );
+
+    private:
+        struct Entry {
+            std::unique_ptr<ViewCanvas> canvas;
+            ViewPaletteTreeState tree_state;
+            // ImGui frame it was last drawn in
+            int last_used = 0;
+            // What the preview was built from, see nest_preview_hash()
+            size_t content_hash = 0;
+        };
+        std::unordered_map<UUID, Entry> entries;
+        const Project *project = nullptr;
+        int revision = -1;
+        int tileset_generation = -1;
+};
+
 /**
  * =============== Windows ===============
  */
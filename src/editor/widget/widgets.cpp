@@ -1,6 +1,7 @@
 #include "widget/widgets.h"
 
 #include <optional>
+#include <unordered_map>
 
 #include "editable_id.h"
 #include "cata_tiles.h"
@@ -20,7 +21,20 @@
 #endif
 #include <imgui/imgui_internal.h>
 
-SpriteRef::SpriteRef( const std::string &id )
+namespace
+{
+
+/**
+ * Tile indices resolved from string ids, shared by every SpriteRef across frames, one per
+ * tile context. Resolving goes through the tileset lookups and looks_like chains, which is
+ * too slow to do for every palette entry every frame.
+ */
+struct SpriteResolutionCache {
+    int tileset_generation = -1;
+    std::unordered_map<std::string, int> tiles;
+};
+
+int resolve_sprite( const std::string &id )
 {
     const tileset &tset = tilecontext->get_tileset();
     const tile_type *t = tset.find_tile_type( id );
@@ -41,8 +55,26 @@ SpriteRef::SpriteRef( const std::string &id )
         }
     }
     if (t) {
-        tile_idx = t->fg.begin()->obj[0];
+        return t->fg.begin()->obj[0];
+    }
+    return -1;
+}
+
+} // namespace
+
+SpriteRef::SpriteRef( const std::string &id )
+{
+    static std::unordered_map<const cata_tiles *, SpriteResolutionCache> caches;
+    SpriteResolutionCache &cache = caches[tilecontext.get()];
+    if( cache.tileset_generation != tilecontext->get_tileset_generation() ) {
+        cache.tiles.clear();
+        cache.tileset_generation = tilecontext->get_tileset_generation();
+    }
+    auto it = cache.tiles.find( id );
+    if( it == cache.tiles.end() ) {
+        it = cache.tiles.emplace( id, resolve_sprite( id ) ).first;
     }
+    tile_idx = it->second;
 }
 
 std::pair<ImVec2, ImVec2> SpriteRef::make_uvs() const
@@ -81,6 +81,11 @@ static void advance_jsin( TextJsonIn *jsin, flexbuffers::Reference root, const J
     }
 }
 
+std::filesystem::path Json::get_source_path() const
+{
+    return root_->get_source_path();
+}
+
 void Json::throw_error( const JsonPath &path, int offset, const std::string &message ) const
 {
     std::unique_ptr<std::istream> original_json = root_->get_source_stream();
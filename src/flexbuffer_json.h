@@ -101,6 +101,9 @@ class Json
 
         static const std::string &flexbuffer_type_to_string( flexbuffers::Type t );
 
+        // Path of the json file this value was parsed from, empty if it didn't come from a file.
+        std::filesystem::path get_source_path() const;
+
         // Atomically sets whether Json destructors report unvisited members or not. Returns the prior value.
         static bool globally_report_unvisited_members( bool do_report );
 
@@ -669,6 +672,7 @@ class JsonObject : JsonWithPath
         }
 
         using Json::str;
+        using Json::get_source_path;
 
         class const_iterator;
         friend const_iterator;
@@ -13287,6 +13287,9 @@ point_rel_sm game::update_map( int &x, int &y, bool z_level_changed )
     // Update what parts of the world map we can see
     update_overmap_seen();
 
+    // Get a head start on the overmaps we're heading for
+    overmap_buffer.pregenerate_ahead( u.pos_abs_omt(), shift );
+
     return shift;
 }
 
@@ -1146,6 +1146,8 @@ class game
         bool enter_editor_on_start = false;
         std::optional<std::string> load_editor_project_on_start;
         std::optional<std::string> export_editor_project_on_start;
+        std::optional<std::string> sample_editor_project_on_start;
+        int sample_editor_project_count = 0;
 
         void update_unique_npc_location( const std::string &id, point_abs_om loc );
         point_abs_om get_unique_npc_location( const std::string &id );
@@ -2,7 +2,9 @@
 
 #include <clocale>
 #include <algorithm>
+#include <array>
 #include <bitset>
+#include <charconv>
 #include <cmath> // IWYU pragma: keep
 #include <cstdint>
 #include <cstdio>
@@ -15,6 +17,8 @@
 #include <set>
 #include <sstream> // IWYU pragma: keep
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <utility>
 #include <vector>
 
@@ -2223,206 +2227,303 @@ std::string TextJsonIn::substr( size_t pos, size_t len )
     return ret;
 }
 
-JsonOut::JsonOut( std::ostream &s, bool pretty, int depth ) :
-    stream( &s ), pretty_print( pretty ), indent_level( depth )
+// ensure consistent and locale-independent formatting of numerals
+static void set_json_number_format( std::ostream &stream )
 {
-    // ensure consistent and locale-independent formatting of numerals
-    stream->imbue( std::locale::classic() );
-    stream->setf( std::ios_base::showpoint );
-    stream->setf( std::ios_base::dec, std::ostream::basefield );
-    stream->setf( std::ios_base::fixed, std::ostream::floatfield );
+    stream.imbue( std::locale::classic() );
+    stream.setf( std::ios_base::showpoint );
+    stream.setf( std::ios_base::dec, std::ostream::basefield );
+    stream.setf( std::ios_base::fixed, std::ostream::floatfield );
 
     // automatically stringify bool to "true" or "false"
-    stream->setf( std::ios_base::boolalpha );
+    stream.setf( std::ios_base::boolalpha );
+}
+
+JsonOut::JsonOut( std::ostream &s, bool pretty, int depth ) :
+    stream( &s ), buffer( &stream_buffer ), pretty_print( pretty ), indent_level( depth )
+{
+    set_json_number_format( *stream );
+}
+
+JsonOut::JsonOut( std::string &s, bool pretty, int depth ) :
+    stream( nullptr ), buffer( &s ), pretty_print( pretty ), indent_level( depth )
+{
 }
 
 int JsonOut::tell()
 {
+    if( stream == nullptr ) {
+        return buffer->size();
+    }
     return stream->tellp();
 }
 
 void JsonOut::seek( int pos )
 {
-    stream->clear();
-    stream->seekp( pos );
+    if( stream == nullptr ) {
+        buffer->resize( pos );
+    } else {
+        stream->clear();
+        stream->seekp( pos );
+    }
     need_separator = false;
 }
 
+void JsonOut::put_indent()
+{
+    buffer->append( static_cast<size_t>( std::max( indent_level, 0 ) ) * 2, ' ' );
+}
+
 void JsonOut::write_indent()
 {
-    std::fill_n( std::ostream_iterator<char>( *stream ), indent_level * 2, ' ' );
+    put_indent();
+    flush();
 }
 
-void JsonOut::write_separator()
+void JsonOut::put_separator()
 {
     if( !need_separator ) {
         return;
     }
-    stream->put( ',' );
+    buffer->push_back( ',' );
     if( pretty_print ) {
         // Wrap after separator between objects and between members of top-level objects.
         if( indent_level < 2 || need_wrap.back() ) {
-            stream->put( '\n' );
-            write_indent();
+            buffer->push_back( '\n' );
+            put_indent();
         } else {
             // Otherwise pad after commas.
-            stream->put( ' ' );
+            buffer->push_back( ' ' );
         }
     }
     need_separator = false;
 }
 
+void JsonOut::write_separator()
+{
+    put_separator();
+    flush();
+}
+
 void JsonOut::write_member_separator()
 {
     if( pretty_print ) {
-        stream->write( ": ", 2 );
+        buffer->append( ": ", 2 );
     } else {
-        stream->put( ':' );
+        buffer->push_back( ':' );
     }
     need_separator = false;
+    flush();
 }
 
-void JsonOut::start_pretty()
+void JsonOut::put_pretty( int indent_change, int wrap_below )
 {
     if( pretty_print ) {
-        indent_level += 1;
-        // Wrap after top level object and array opening.
-        if( indent_level < 2 || need_wrap.back() ) {
-            stream->put( '\n' );
-            write_indent();
+        indent_level += indent_change;
+        if( indent_level < wrap_below || need_wrap.back() ) {
+            buffer->push_back( '\n' );
+            put_indent();
         } else {
-            // Otherwise pad after opening.
-            stream->put( ' ' );
+            // Otherwise pad after opening or before ending.
+            buffer->push_back( ' ' );
         }
     }
 }
 
+void JsonOut::start_pretty()
+{
+    // Wrap after top level object and array opening.
+    put_pretty( 1, 2 );
+    flush();
+}
+
 void JsonOut::end_pretty()
 {
-    if( pretty_print ) {
-        indent_level -= 1;
-        // Wrap after ending top level array and object.
-        // Also wrap in the special case of exiting an array containing an object.
-        if( indent_level < 1 || need_wrap.back() ) {
-            stream->put( '\n' );
-            write_indent();
-        } else {
-            // Otherwise pad after ending.
-            stream->put( ' ' );
-        }
-    }
+    // Wrap after ending top level array and object.
+    // Also wrap in the special case of exiting an array containing an object.
+    put_pretty( -1, 1 );
+    flush();
 }
 
 void JsonOut::start_object( bool wrap )
 {
     if( need_separator ) {
-        write_separator();
+        put_separator();
     }
-    stream->put( '{' );
+    buffer->push_back( '{' );
     need_wrap.push_back( wrap );
-    start_pretty();
+    put_pretty( 1, 2 );
     need_separator = false;
+    flush();
 }
 
 void JsonOut::end_object()
 {
-    end_pretty();
+    put_pretty( -1, 1 );
     need_wrap.pop_back();
-    stream->put( '}' );
+    buffer->push_back( '}' );
     need_separator = true;
+    flush();
 }
 
 void JsonOut::start_array( bool wrap )
 {
     if( need_separator ) {
-        write_separator();
+        put_separator();
     }
-    stream->put( '[' );
+    buffer->push_back( '[' );
     need_wrap.push_back( wrap );
-    start_pretty();
+    put_pretty( 1, 2 );
     need_separator = false;
+    flush();
 }
 
 void JsonOut::end_array()
 {
-    end_pretty();
+    put_pretty( -1, 1 );
     need_wrap.pop_back();
-    stream->put( ']' );
+    buffer->push_back( ']' );
     need_separator = true;
+    flush();
 }
 
 void JsonOut::write_null()
 {
     if( need_separator ) {
-        write_separator();
+        put_separator();
     }
-    stream->write( "null", 4 );
+    buffer->append( "null", 4 );
     need_separator = true;
+    flush();
 }
 
-void JsonOut::write( std::string_view val )
+void JsonOut::put_number( long long val )
 {
-    if( need_separator ) {
-        write_separator();
+    std::array<char, std::numeric_limits<long long>::digits10 + 3> digits;
+    const std::to_chars_result res = std::to_chars( digits.data(), digits.data() + digits.size(), val );
+    buffer->append( digits.data(), res.ptr );
+}
+
+void JsonOut::put_number( unsigned long long val )
+{
+    std::array<char, std::numeric_limits<unsigned long long>::digits10 + 3> digits;
+    const std::to_chars_result res = std::to_chars( digits.data(), digits.data() + digits.size(), val );
+    buffer->append( digits.data(), res.ptr );
+}
+
+// Streams write floating point numbers in fixed notation with the default precision of 6.
+static constexpr int json_float_precision = 6;
+
+void JsonOut::put_number( double val )
+{
+#if defined(__cpp_lib_to_chars)
+    // Enough for the integer digits of the largest double, the point and the decimals
+    std::array < char, std::numeric_limits<double>::max_exponent10 + json_float_precision + 8 > digits;
+    const std::to_chars_result res = std::to_chars( digits.data(), digits.data() + digits.size(), val,
+                                     std::chars_format::fixed, json_float_precision );
+    if( res.ec == std::errc() ) {
+        buffer->append( digits.data(), res.ptr );
+        return;
     }
-    stream->put( '"' );
-    for( const char &i : val ) {
-        unsigned char ch = i;
+#endif
+    std::ostringstream formatted;
+    set_json_number_format( formatted );
+    formatted << val;
+    buffer->append( formatted.str() );
+}
+
+void JsonOut::put_number( long double val )
+{
+    std::ostringstream formatted;
+    set_json_number_format( formatted );
+    formatted << val;
+    buffer->append( formatted.str() );
+}
+
+static bool needs_escaping( unsigned char ch )
+{
+    return ch == '"' || ch == '\\' || ch < 0x20;
+}
+
+void JsonOut::put_string( std::string_view val )
+{
+    buffer->push_back( '"' );
+    // Most strings, and member names in particular, don't need escaping at all, so they get
+    // copied over in runs.
+    size_t run_start = 0;
+    for( size_t i = 0; i < val.size(); ++i ) {
+        const unsigned char ch = val[i];
+        if( !needs_escaping( ch ) ) {
+            continue;
+        }
+        buffer->append( val.data() + run_start, i - run_start );
+        run_start = i + 1;
         if( ch == '"' ) {
-            stream->write( "\\\"", 2 );
+            buffer->append( "\\\"", 2 );
         } else if( ch == '\\' ) {
-            stream->write( "\\\\", 2 );
-        } else if( ch == '/' ) {
-            // don't technically need to escape this
-            stream->put( '/' );
+            buffer->append( "\\\\", 2 );
         } else if( ch == '\b' ) {
-            stream->write( "\\b", 2 );
+            buffer->append( "\\b", 2 );
         } else if( ch == '\f' ) {
-            stream->write( "\\f", 2 );
+            buffer->append( "\\f", 2 );
         } else if( ch == '\n' ) {
-            stream->write( "\\n", 2 );
+            buffer->append( "\\n", 2 );
         } else if( ch == '\r' ) {
-            stream->write( "\\r", 2 );
+            buffer->append( "\\r", 2 );
         } else if( ch == '\t' ) {
-            stream->write( "\\t", 2 );
-        } else if( ch < 0x20 ) {
+            buffer->append( "\\t", 2 );
+        } else {
             // convert to "\uxxxx" unicode escape
-            stream->write( "\\u00", 4 );
-            stream->put( ( ch < 0x10 ) ? '0' : '1' );
+            buffer->append( "\\u00", 4 );
+            buffer->push_back( ( ch < 0x10 ) ? '0' : '1' );
             char remainder = ch & 0x0F;
             if( remainder < 0x0A ) {
-                stream->put( '0' + remainder );
+                buffer->push_back( '0' + remainder );
             } else {
-                stream->put( 'A' + ( remainder - 0x0A ) );
+                buffer->push_back( 'A' + ( remainder - 0x0A ) );
             }
-        } else {
-            stream->put( ch );
         }
     }
-    stream->put( '"' );
+    buffer->append( val.data() + run_start, val.size() - run_start );
+    buffer->push_back( '"' );
+}
+
+void JsonOut::write( std::string_view val )
+{
+    if( need_separator ) {
+        put_separator();
+    }
+    put_string( val );
     need_separator = true;
+    flush();
 }
 
 template<size_t N>
 void JsonOut::write( const std::bitset<N> &b )
 {
     if( need_separator ) {
-        write_separator();
-    }
-    std::string converted = b.to_string();
-    stream->put( '"' );
-    for( char &i : converted ) {
-        unsigned char ch = i;
-        stream->put( ch );
+        put_separator();
     }
-    stream->put( '"' );
+    buffer->push_back( '"' );
+    buffer->append( b.to_string() );
+    buffer->push_back( '"' );
     need_separator = true;
+    flush();
 }
 
 void JsonOut::member( std::string_view name )
 {
-    write( name );
-    write_member_separator();
+    if( need_separator ) {
+        put_separator();
+    }
+    put_string( name );
+    if( pretty_print ) {
+        buffer->append( ": ", 2 );
+    } else {
+        buffer->push_back( ':' );
+    }
+    need_separator = false;
+    flush();
 }
 
 void JsonOut::null_member( std::string_view name )
@@ -12,6 +12,7 @@
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -733,18 +734,43 @@ class TextJsonIn
  *
  * Basic containers such as maps, sets and vectors,
  * can be serialized automatically by write() and member().
+ *
+ * Each call formats its output into a contiguous buffer first. Constructed with a string, that
+ * string is the buffer and everything gets appended to it, which is the fastest way to write
+ * JSON that ends up in memory anyway. Constructed with a stream, the buffer gets written to the
+ * stream at the end of every call, so writing to the stream in between calls works as before.
  */
 class JsonOut
 {
     private:
         std::ostream *stream;
+        std::string stream_buffer;
+        std::string *buffer;
         bool pretty_print;
         std::vector<bool> need_wrap;
         int indent_level = 0;
         bool need_separator = false;
 
+        void put_indent();
+        void put_separator();
+        void put_pretty( int indent_change, int wrap_below );
+        void put_string( std::string_view val );
+        void put_number( long long val );
+        void put_number( unsigned long long val );
+        void put_number( double val );
+        void put_number( long double val );
+        // Hand what was written so far to the stream, if there's one.
+        void flush() {
+            if( stream != nullptr && !buffer->empty() ) {
+                stream->write( buffer->data(), buffer->size() );
+                buffer->clear();
+            }
+        }
+
     public:
         explicit JsonOut( std::ostream &stream, bool pretty_print = false, int depth = 0 );
+        /** Appends to @p buffer instead of writing to a stream. */
+        explicit JsonOut( std::string &buffer, bool pretty_print = false, int depth = 0 );
         JsonOut( const JsonOut & ) = delete;
         JsonOut &operator=( const JsonOut & ) = delete;
 
@@ -758,10 +784,17 @@ class JsonOut
         void set_need_separator() {
             need_separator = true;
         }
+        // null when writing to a string
         std::ostream *get_stream() {
             return stream;
         }
+        // Write already formatted JSON as it is
+        void write_raw( std::string_view text ) {
+            buffer->append( text );
+            flush();
+        }
         int tell();
+        // When writing to a string, drops everything written after pos.
         void seek( int pos );
         void start_pretty();
         void end_pretty();
@@ -776,11 +809,25 @@ class JsonOut
 
         template <typename T, std::enable_if_t<std::is_fundamental_v<T>, int> = 0>
         void write( T val ) {
-            if( need_separator ) {
-                write_separator();
+            static_assert( std::is_arithmetic_v<T>, "only numbers and booleans can be written" );
+            if constexpr( std::is_same_v<T, bool> ) {
+                write_bool( val );
+            } else {
+                if( need_separator ) {
+                    put_separator();
+                }
+                if constexpr( std::is_floating_point_v<T> ) {
+                    // Floats get formatted with the precision of doubles, as streams do.
+                    using promoted = std::conditional_t<std::is_same_v<T, long double>, long double, double>;
+                    put_number( static_cast<promoted>( val ) );
+                } else if constexpr( std::is_signed_v<T> ) {
+                    put_number( static_cast<long long>( val ) );
+                } else {
+                    put_number( static_cast<unsigned long long>( val ) );
+                }
+                need_separator = true;
+                flush();
             }
-            *stream << val;
-            need_separator = true;
         }
 
         /// Overload that calls a global function `serialize(const T&,JsonOut&)`, if available.
@@ -810,20 +857,17 @@ class JsonOut
         // strings need escaping and quoting
         void write( std::string_view val );
         void write( const char *val ) {
-            write( std::string( val ) );
+            write( std::string_view( val ) );
         }
 
         // special overload for booleans that must be written as 'true'/'false'
         void write_bool( bool val ) {
             if( need_separator ) {
-                write_separator();
-            }
-            if( val ) {
-                *stream << "true";
-            } else {
-                *stream << "false";
+                put_separator();
             }
+            buffer->append( val ? "true" : "false" );
             need_separator = true;
+            flush();
         }
 
         // char should always be written as an unquoted numeral
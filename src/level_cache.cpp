@@ -15,6 +15,7 @@ level_cache::level_cache()
     std::fill_n( &lm[0][0], map_dimensions, four_zeros );
     std::fill_n( &sm[0][0], map_dimensions, 0.0f );
     std::fill_n( &light_source_buffer[0][0], map_dimensions, 0.0f );
+    clear_bulk_light();
     std::fill_n( &outside_cache[0][0], map_dimensions, false );
     std::fill_n( &floor_cache[0][0], map_dimensions, false );
     std::fill_n( &transparency_cache[0][0], map_dimensions, 0.0f );
@@ -25,6 +26,15 @@ level_cache::level_cache()
     clear_vehicle_cache();
 }
 
+void level_cache::clear_bulk_light()
+{
+    const int map_dimensions = MAPSIZE_X * MAPSIZE_Y;
+    std::fill_n( &bulk_lm[0][0], map_dimensions, four_quadrants( 0.0f ) );
+    std::fill_n( &bulk_sm[0][0], map_dimensions, 0.0f );
+    std::fill_n( &bulk_light_sources[0][0], map_dimensions, 0.0f );
+    std::fill_n( &bulk_light_transparency[0][0], map_dimensions, 0.0f );
+}
+
 bool level_cache::get_veh_in_active_range() const
 {
     return !veh_cached_parts.empty();
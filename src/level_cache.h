@@ -35,6 +35,13 @@ struct level_cache {
         // To prevent redundant ray casting into neighbors: precalculate bulk light source positions.
         // This is only valid for the duration of generate_lightmap
         cata::mdarray<float, point_bub_ms> light_source_buffer;
+        // Light of the sources in light_source_buffer, kept between calls of generate_lightmap
+        // together with the sources and transparency it was computed from, so that only the
+        // parts around changes need to be cast again.
+        cata::mdarray<four_quadrants, point_bub_ms> bulk_lm;
+        cata::mdarray<float, point_bub_ms> bulk_sm;
+        cata::mdarray<float, point_bub_ms> bulk_light_sources;
+        cata::mdarray<float, point_bub_ms> bulk_light_transparency;
 
         // Cache of natural light level is useful if it needs to be in sync with the light cache.
         float natural_light_level_cache;
@@ -81,6 +88,9 @@ struct level_cache {
         std::set<vehicle *> vehicle_list;
         std::set<vehicle *> zone_vehicles;
 
+        // Forget the kept bulk light, the next lightmap casts all of it again.
+        void clear_bulk_light();
+
         bool get_veh_in_active_range() const;
         bool get_veh_exists_at( const tripoint_bub_ms &pt ) const;
         std::pair<vehicle *, int> get_veh_cached_parts( const tripoint_bub_ms &pt ) const;
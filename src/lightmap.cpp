@@ -61,6 +61,8 @@ static constexpr point_bub_ms lightmap_boundary_max( LIGHTMAP_CACHE_X, LIGHTMAP_
 static const half_open_rectangle<point_bub_ms> lightmap_boundaries(
     lightmap_boundary_min, lightmap_boundary_max );
 
+static void update_bulk_light( level_cache &map_cache );
+
 std::string four_quadrants::to_string() const
 {
     return string_format( "(%.2f,%.2f,%.2f,%.2f)",
@@ -650,12 +652,17 @@ void map::generate_lightmap( const int zlev )
       This may seem like extra work, but take a 12x12 raging inferno:
         unbuffered: (12^2)*(160*4) = apply_light_ray x 92160
         buffered:   (12*4)*(160)   = apply_light_ray x 7680
+      Their light is kept from the previous call and only cast again around what changed since,
+      then merged in. Light only ever gets combined with max, so that's the same as casting it
+      into lm directly.
     */
-    const tripoint_bub_ms cache_start( 0, 0, zlev );
-    const tripoint_bub_ms cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
-    for( const tripoint_bub_ms &p : points_in_rectangle( cache_start, cache_end ) ) {
-        if( light_source_buffer[p.x()][p.y()] > 0.0 ) {
-            apply_light_source( p, light_source_buffer[p.x()][p.y()] );
+    update_bulk_light( map_cache );
+    const auto &bulk_lm = map_cache.bulk_lm;
+    const auto &bulk_sm = map_cache.bulk_sm;
+    for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+        for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+            lm[x][y] = elementwise_max( lm[x][y], bulk_lm[x][y] );
+            sm[x][y] = std::max( sm[x][y], bulk_sm[x][y] );
         }
     }
     for( const std::pair<tripoint_bub_ms, float> &elem : lm_override ) {
@@ -1214,19 +1221,15 @@ static bool light_check( const float &transparency, const float &intensity )
     return transparency > LIGHT_TRANSPARENCY_SOLID && intensity > LIGHT_AMBIENT_LOW;
 }
 
-void map::apply_light_source( const tripoint_bub_ms &p, float luminance )
+// Cast the light of a source at @p p2 into @p lm and @p sm, skipping the directions the bulk
+// sources next to it already cover.
+static void cast_light_source( cata::mdarray<four_quadrants, point_bub_ms> &lm,
+                               cata::mdarray<float, point_bub_ms> &sm,
+                               const cata::mdarray<float, point_bub_ms> &transparency_cache,
+                               const cata::mdarray<float, point_bub_ms> &light_source_buffer,
+                               const point_bub_ms &p2, float luminance )
 {
-    level_cache &cache = get_cache( p.z() );
-    cata::mdarray<four_quadrants, point_bub_ms> &lm = cache.lm;
-    cata::mdarray<float, point_bub_ms> &sm = cache.sm;
-    cata::mdarray<float, point_bub_ms> &transparency_cache =
-        cache.transparency_cache;
-    cata::mdarray<float, point_bub_ms> &light_source_buffer =
-        cache.light_source_buffer;
-
-    const point_bub_ms p2( p.xy() );
-
-    if( inbounds( p ) ) {
+    if( lightmap_boundaries.contains( p2 ) ) {
         const float min_light = std::max( static_cast<float>( lit_level::LOW ), luminance );
         lm[p2.x()][p2.y()] = elementwise_max( lm[p2.x()][p2.y()], min_light );
         sm[p2.x()][p2.y()] = std::max( sm[p2.x()][p2.y()], luminance );
@@ -1296,6 +1299,174 @@ void map::apply_light_source( const tripoint_bub_ms &p, float luminance )
     }
 }
 
+void map::apply_light_source( const tripoint_bub_ms &p, float luminance )
+{
+    level_cache &cache = get_cache( p.z() );
+    cast_light_source( cache.lm, cache.sm, cache.transparency_cache, cache.light_source_buffer,
+                       p.xy(), luminance );
+}
+
+// How far from a source of this luminance cast_light_source() can reach. Light falls off at least
+// with the inverse of the distance, and castLight stops once it's no brighter than
+// LIGHT_AMBIENT_LOW.
+static int light_source_reach( float luminance )
+{
+    if( luminance <= lit_level::LOW ) {
+        return 0;
+    } else if( luminance <= lit_level::BRIGHT_ONLY ) {
+        luminance = 1.49f;
+    }
+    return std::min( MAX_VIEW_DISTANCE,
+                     static_cast<int>( std::ceil( luminance / LIGHT_AMBIENT_LOW ) ) + 1 );
+}
+
+// Calls f with the index of every submap the square of radius reach around p touches, until it
+// returns true.
+template<typename F>
+static void for_each_submap_within( const point_bub_ms &p, int reach, F f )
+{
+    const int min_x = std::max( p.x() - reach, 0 ) / SEEX;
+    const int max_x = std::min( p.x() + reach, LIGHTMAP_CACHE_X - 1 ) / SEEX;
+    const int min_y = std::max( p.y() - reach, 0 ) / SEEY;
+    const int max_y = std::min( p.y() + reach, LIGHTMAP_CACHE_Y - 1 ) / SEEY;
+    for( int smx = min_x; smx <= max_x; ++smx ) {
+        for( int smy = min_y; smy <= max_y; ++smy ) {
+            if( f( smx * MAPSIZE + smy ) ) {
+                return;
+            }
+        }
+    }
+}
+
+// Fewer bulk sources to cast than this per thread aren't worth starting the thread for.
+static constexpr int min_bulk_sources_per_thread = 32;
+
+// Bring bulk_lm and bulk_sm up to date with light_source_buffer and transparency_cache.
+static void update_bulk_light( level_cache &map_cache )
+{
+    const auto &light_source_buffer = map_cache.light_source_buffer;
+    const auto &transparency_cache = map_cache.transparency_cache;
+    auto &prev_sources = map_cache.bulk_light_sources;
+    auto &prev_transparency = map_cache.bulk_light_transparency;
+
+    std::bitset<MAPSIZE *MAPSIZE> transparency_changed;
+    for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+        for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+            if( transparency_cache[x][y] != prev_transparency[x][y] ) {
+                transparency_changed.set( ( x / SEEX ) * MAPSIZE + y / SEEY );
+            }
+        }
+    }
+    const auto source_changed = [&]( int x, int y ) {
+        return x >= 0 && y >= 0 && x < LIGHTMAP_CACHE_X && y < LIGHTMAP_CACHE_Y &&
+               light_source_buffer[x][y] != prev_sources[x][y];
+    };
+
+    // A source has to be cast again if it changed, if one next to it did (see
+    // cast_light_source), or if transparency changed anywhere it reaches. Everything it
+    // reached before or reaches now has to be recomputed then.
+    std::bitset<MAPSIZE *MAPSIZE> dirty;
+    for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+        for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+            if( light_source_buffer[x][y] <= 0.0f && prev_sources[x][y] <= 0.0f ) {
+                continue;
+            }
+            const point_bub_ms p( x, y );
+            const int reach = std::max( light_source_reach( light_source_buffer[x][y] ),
+                                        light_source_reach( prev_sources[x][y] ) );
+            bool changed = source_changed( x, y ) || source_changed( x - 1, y ) ||
+                           source_changed( x + 1, y ) || source_changed( x, y - 1 ) ||
+                           source_changed( x, y + 1 );
+            if( !changed ) {
+                for_each_submap_within( p, reach, [&]( int sm_index ) {
+                    changed = transparency_changed[sm_index];
+                    return changed;
+                } );
+            }
+            if( changed ) {
+                for_each_submap_within( p, reach, [&]( int sm_index ) {
+                    dirty.set( sm_index );
+                    return false;
+                } );
+            }
+        }
+    }
+
+    if( dirty.any() ) {
+        auto &bulk_lm = map_cache.bulk_lm;
+        auto &bulk_sm = map_cache.bulk_sm;
+        for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+            for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+                if( dirty[( x / SEEX ) * MAPSIZE + y / SEEY] ) {
+                    bulk_lm[x][y] = four_quadrants( 0.0f );
+                    bulk_sm[x][y] = 0.0f;
+                }
+            }
+        }
+        // Sources that didn't change light up the same tiles as before outside of the dirty
+        // submaps, so casting them again only matters inside of them.
+        std::vector<std::pair<point_bub_ms, float>> recast;
+        for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+            for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+                const float luminance = light_source_buffer[x][y];
+                if( luminance <= 0.0f ) {
+                    continue;
+                }
+                const point_bub_ms p( x, y );
+                bool touches_dirty = false;
+                for_each_submap_within( p, light_source_reach( luminance ), [&]( int sm_index ) {
+                    touches_dirty = dirty[sm_index];
+                    return touches_dirty;
+                } );
+                if( touches_dirty ) {
+                    recast.emplace_back( p, luminance );
+                }
+            }
+        }
+
+        // A whole burning city is worth spreading over threads, a campfire isn't. All threads
+        // but this one cast into buffers of their own that get merged in afterwards, which
+        // gives the same result since light is only ever combined by taking the max.
+        const int num_threads = shadowcasting_threads( static_cast<int>( recast.size() ) /
+                                min_bulk_sources_per_thread );
+        struct light_buffers {
+            cata::mdarray<four_quadrants, point_bub_ms> lm;
+            cata::mdarray<float, point_bub_ms> sm;
+        };
+        thread_local std::vector<std::unique_ptr<light_buffers>> thread_buffers;
+        if( static_cast<int>( thread_buffers.size() ) < num_threads ) {
+            thread_buffers.resize( num_threads );
+        }
+        for( int i = 1; i < num_threads; ++i ) {
+            if( !thread_buffers[i] ) {
+                thread_buffers[i] = std::make_unique<light_buffers>();
+            }
+            thread_buffers[i]->lm.fill( four_quadrants( 0.0f ) );
+            thread_buffers[i]->sm.fill( 0.0f );
+        }
+        run_shadowcasting_jobs( num_threads, [&]( int thread ) {
+            auto &lm = thread == 0 ? bulk_lm : thread_buffers[thread]->lm;
+            auto &sm = thread == 0 ? bulk_sm : thread_buffers[thread]->sm;
+            for( size_t i = thread; i < recast.size(); i += num_threads ) {
+                cast_light_source( lm, sm, transparency_cache, light_source_buffer, recast[i].first,
+                                   recast[i].second );
+            }
+        } );
+        for( int i = 1; i < num_threads; ++i ) {
+            merge_max( bulk_lm, thread_buffers[i]->lm );
+            merge_max( bulk_sm, thread_buffers[i]->sm );
+        }
+    }
+
+    prev_sources = light_source_buffer;
+    prev_transparency = transparency_cache;
+}
+
+void map::clear_bulk_light( int zlev )
+{
+    get_cache( zlev ).clear_bulk_light();
+}
+
 void map::apply_directional_light( const tripoint_bub_ms &p, int direction, float luminance )
 {
     const point_bub_ms p2( p.xy() );
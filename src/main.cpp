@@ -9,6 +9,7 @@
 // IWYU pragma: no_include <sys/signal.h>
 #include <algorithm>
 #include <array>
+#include <charconv>
 #include <clocale>
 #include <cstdio>
 #include <cstdlib>
@@ -48,6 +49,7 @@
 #include "help.h"
 #include "input.h"
 #include "main_menu.h"
+#include "mapgen.h"
 #include "mapsharing.h"
 #include "memory_fast.h"
 #include "options.h"
@@ -287,6 +289,8 @@ struct cli_opts {
     bool enter_editor_on_start = false;
     std::optional<std::string> load_editor_project_on_start;
     std::optional<std::string> export_editor_project_on_start;
+    std::optional<std::string> sample_editor_project_on_start;
+    int sample_editor_project_count = 0;
 };
 
 cli_opts parse_commandline( int argc, const char **argv )
@@ -334,6 +338,16 @@ cli_opts parse_commandline( int argc, const char **argv )
                     return 0;
                 }
             },
+            {
+                "--check-changed-mapgens", {},
+                "Only checks mapgens from json files changed since they last passed the checks",
+                section_default,
+                0,
+                []( int, const char ** ) -> int {
+                    set_check_only_changed_mapgens( true );
+                    return 0;
+                }
+            },
             {
                 "--noverify", {},
                 "Skips JSON verification",
@@ -566,6 +580,25 @@ cli_opts parse_commandline( int argc, const char **argv )
                     result.export_editor_project_on_start = params[0];
                     return 1;
                 }
+            },
+            {
+                "--sample-mapgens", "<path> <count>",
+                "Generate every mapgen of the editor project <count> times, write tile frequencies to <path> once the editor has opened it and quit",
+                {},
+                2,
+                [&]( int, const char **params ) -> int {
+                    const char *const count_begin = params[1];
+                    const char *const count_end = count_begin + std::strlen( count_begin );
+                    int count = 0;
+                    const std::from_chars_result parsed =
+                        std::from_chars( count_begin, count_end, count );
+                    if( parsed.ec != std::errc() || parsed.ptr != count_end || count < 1 ) {
+                        return -1;
+                    }
+                    result.sample_editor_project_on_start = params[0];
+                    result.sample_editor_project_count = count;
+                    return 2;
+                }
             }
         }
     };
@@ -827,6 +860,8 @@ int main( int argc, const char *argv[] )
     g->enter_editor_on_start = cli.enter_editor_on_start;
     g->load_editor_project_on_start = cli.load_editor_project_on_start;
     g->export_editor_project_on_start = cli.export_editor_project_on_start;
+    g->sample_editor_project_on_start = cli.sample_editor_project_on_start;
+    g->sample_editor_project_count = cli.sample_editor_project_count;
     // First load and initialize everything that does not
     // depend on the mods.
     try {
@@ -11,7 +11,9 @@
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "active_item_cache.h"
 #include "ammo.h"
@@ -6529,6 +6531,7 @@ bool map::add_field( const tripoint_bub_ms &p, const field_type_id &type_id, int
     invalidate_max_populated_zlev( p.z() );
 
     if( current_submap->get_field( l ).add_field( converted_type_id, intensity, age ) ) {
+        current_submap->field_tiles.set( submap::field_tile_index( l ) );
         //Only adding it to the count if it doesn't exist.
         if( !current_submap->field_count++ ) {
             get_cache( p.z() ).field_cache.set(
@@ -7296,6 +7299,11 @@ void map::draw_from_above( const catacurses::window &w, const tripoint_bub_ms &p
     }
 }
 
+// Lines of sight remembered by sees()
+static constexpr int skew_vision_cache_size = 100000;
+// Casting a line is cheap, only hand them to worker threads in bulk
+static constexpr int min_sight_lines_per_thread = 256;
+
 bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int range,
                 bool with_fields ) const
 {
@@ -7344,19 +7352,8 @@ bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int ra
 
     // Ugly `if` for now
     if( F.z() == T.z() ) {
-        bresenham( F.xy(), T.xy(), bresenham_slope,
-        [this, f_transparent, &visible, &T]( const point_bub_ms & new_point ) {
-            // Exit before checking the last square, it's still visible even if opaque.
-            if( new_point.x() == T.x() && new_point.y() == T.y() ) {
-                return false;
-            }
-            if( !( this->*f_transparent )( { new_point.x(), new_point.y(), T.z()} ) ) {
-                visible = false;
-                return false;
-            }
-            return true;
-        } );
-        skew_cache.insert( 100000, key, visible ? 1 : 0 );
+        visible = sees_on_level( F, T, bresenham_slope, with_fields );
+        skew_cache.insert( skew_vision_cache_size, key, visible ? 1 : 0 );
         return visible;
     }
 
@@ -7389,10 +7386,66 @@ bool map::sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, const int ra
         last_point = new_point;
         return true;
     } );
-    skew_cache.insert( 100000, key, visible ? 1 : 0 );
+    skew_cache.insert( skew_vision_cache_size, key, visible ? 1 : 0 );
+    return visible;
+}
+
+bool map::sees_on_level( const tripoint_bub_ms &F, const tripoint_bub_ms &T, int &bresenham_slope,
+                         bool with_fields ) const
+{
+    bool ( map:: * f_transparent )( const tripoint_bub_ms & p ) const =
+        with_fields ? &map::is_transparent : &map::is_transparent_wo_fields;
+    bool visible = true;
+    bresenham( F.xy(), T.xy(), bresenham_slope,
+    [this, f_transparent, &visible, &T]( const point_bub_ms & new_point ) {
+        // Exit before checking the last square, it's still visible even if opaque.
+        if( new_point.x() == T.x() && new_point.y() == T.y() ) {
+            return false;
+        }
+        if( !( this->*f_transparent )( { new_point.x(), new_point.y(), T.z()} ) ) {
+            visible = false;
+            return false;
+        }
+        return true;
+    } );
     return visible;
 }
 
+void map::cache_sight_lines( const std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>>
+                             &lines ) const
+{
+    // Only the lines nobody has cast yet, and no more than the cache can hold on to
+    std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>> todo;
+    std::unordered_set<point> keys;
+    for( const std::pair<tripoint_bub_ms, tripoint_bub_ms> &line : lines ) {
+        if( todo.size() >= skew_vision_cache_size / 2 ) {
+            break;
+        }
+        if( line.first.z() != line.second.z() || !inbounds( line.first ) ||
+            !inbounds( line.second ) ) {
+            continue;
+        }
+        const point key = sees_cache_key( line.first, line.second );
+        if( skew_vision_cache.get( key, -1 ) == -1 && keys.insert( key ).second ) {
+            todo.push_back( line );
+        }
+    }
+
+    std::vector<char> visible( todo.size() );
+    const int num_threads = shadowcasting_threads( todo.size() / min_sight_lines_per_thread );
+    run_shadowcasting_jobs( num_threads, [&]( int thread ) {
+        for( size_t i = thread; i < todo.size(); i += num_threads ) {
+            int bresenham_slope = 0;
+            visible[i] = sees_on_level( todo[i].first, todo[i].second, bresenham_slope, true );
+        }
+    } );
+
+    for( size_t i = 0; i < todo.size(); ++i ) {
+        skew_vision_cache.insert( skew_vision_cache_size, sees_cache_key( todo[i].first,
+                                  todo[i].second ), visible[i] );
+    }
+}
+
 int map::obstacle_coverage( const tripoint_bub_ms &loc1, const tripoint_bub_ms &loc2 ) const
 {
     // Can't hide if you are standing on furniture, or non-flat slowing-down terrain tile.
@@ -10169,7 +10222,7 @@ void map::function_over( const tripoint_bub_ms &start, const tripoint_bub_ms &en
 
 void map::scent_blockers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &blocks_scent,
                           std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &reduces_scent,
-                          const point_bub_ms &min, const point_bub_ms &max )
+                          const point_bub_ms &min, const point_bub_ms &max ) const
 {
     ter_furn_flag reduce = ter_furn_flag::TFLAG_REDUCE_SCENT;
     ter_furn_flag block = ter_furn_flag::TFLAG_NO_SCENT;
@@ -10193,11 +10246,13 @@ void map::scent_blockers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &bl
 
     function_over( tripoint_bub_ms( min, abs_sub.z() ), tripoint_bub_ms( max, abs_sub.z() ),
                    fill_values );
+}
 
+void map::vehicle_scent_reducers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y>
+                                  &reduces_scent, const point_bub_ms &min, const point_bub_ms &max )
+{
     const inclusive_rectangle<point_bub_ms> local_bounds( min, max );
 
-    // Now vehicles
-
     VehicleList vehs = get_vehicles();
     for( wrapped_vehicle &wrapped_veh : vehs ) {
         vehicle &veh = *( wrapped_veh.v );
@@ -10391,14 +10446,23 @@ pathfinding_cache &map::get_pathfinding_cache( int zlev ) const
 void map::set_pathfinding_cache_dirty( const int zlev )
 {
     if( inbounds_z( zlev ) ) {
-        get_pathfinding_cache( zlev ).dirty = true;
+        pathfinding_cache &cache = get_pathfinding_cache( zlev );
+        cache.dirty = true;
+        cache.generation++;
     }
 }
 
+int map::get_pathfinding_generation( const int zlev ) const
+{
+    return get_pathfinding_cache( zlev ).generation;
+}
+
 void map::set_pathfinding_cache_dirty( const tripoint_bub_ms &p )
 {
     if( inbounds( p ) ) {
-        get_pathfinding_cache( p.z() ).dirty_points.insert( p.xy() );
+        pathfinding_cache &cache = get_pathfinding_cache( p.z() );
+        cache.dirty_points.insert( p.xy() );
+        cache.generation++;
     }
 }
 
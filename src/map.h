@@ -96,6 +96,7 @@ using VehicleList = std::vector<wrapped_vehicle>;
 class map;
 
 enum class ter_furn_flag : int;
+struct path_flow_field;
 struct pathfinding_cache;
 struct pathfinding_settings;
 struct pathfinding_target;
@@ -424,6 +425,13 @@ class map
         void set_pathfinding_cache_dirty( const tripoint_bub_ms &p );
         /*@}*/
 
+        /**
+         * Goes up whenever the pathfinding cache of the z-level is marked dirty, which includes
+         * every change of terrain and furniture. Lets caches of other things derived from those
+         * tell when they are out of date.
+         */
+        int get_pathfinding_generation( int zlev ) const;
+
         void invalidate_map_cache( int zlev );
 
         // @returns true if map memory decoration should be re/memorized
@@ -639,6 +647,14 @@ class map
         */
         bool sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, int range,
                    bool with_fields = true ) const;
+        /**
+         * Cast the given lines of sight on worker threads and remember the results, so that
+         * later calls to sees() for them are answered from the cache. Only lines within a
+         * single z-level are cast ahead of time, as those read nothing but the transparency
+         * cache. Each line is cast from its first point to its second.
+         */
+        void cache_sight_lines( const std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>>
+                                &lines ) const;
     private:
         /**
          * Don't expose the slope adjust outside map functions.
@@ -653,6 +669,9 @@ class map
         bool sees( const tripoint_bub_ms &F, const tripoint_bub_ms &T, int range, int &bresenham_slope,
                    bool with_fields = true, bool allow_cached = true ) const;
         point sees_cache_key( const tripoint_bub_ms &from, const tripoint_bub_ms &to ) const;
+        // Bresenham line of sight between two points on the same z-level, without the cache
+        bool sees_on_level( const tripoint_bub_ms &F, const tripoint_bub_ms &T, int &bresenham_slope,
+                            bool with_fields ) const;
     public:
         /**
         * Returns coverage of target in relation to the observer. Target is loc2, observer is loc1.
@@ -734,6 +753,26 @@ class map
          */
         std::vector<tripoint_bub_ms> route( const Creature &who, const pathfinding_target &target ) const;
 
+        /**
+         * Like route(), for when many creatures head for the same target with the same settings,
+         * as a horde does. The cost of reaching the target from everywhere on its z-level is
+         * worked out once per turn and shared, so each of them only has to follow it downhill.
+         * A route is only taken from the shared costs if it's as cheap as what route() finds and
+         * stays within the area route() searches, though where there are several equally cheap
+         * routes it may pick another one. Falls back to route() where the shared costs don't
+         * apply: across z-levels, where route() could detour through the level below, or when
+         * @p avoid blocks the way. Something to avoid next to @p f is checked before the shared
+         * costs are even asked for.
+         */
+        std::vector<tripoint_bub_ms> route_shared( const tripoint_bub_ms &f,
+                const pathfinding_target &target, const pathfinding_settings &settings,
+                const std::function<bool( const tripoint_bub_ms & )> &avoid ) const;
+        std::vector<tripoint_bub_ms> route_shared( const Creature &who,
+                const pathfinding_target &target ) const;
+        /** The shared costs route_shared() keeps for @p target and @p settings, if any. */
+        const path_flow_field *find_path_flow_field( const pathfinding_target &target,
+                const pathfinding_settings &settings ) const;
+
         // Get a straight route from f to t, only along non-rough terrain. Returns an empty vector
         // if that is not possible.
         std::vector<tripoint_bub_ms> straight_route( const tripoint_bub_ms &f,
@@ -754,6 +793,15 @@ class map
         int extra_cost( const tripoint_bub_ms &cur, const tripoint_bub_ms &p,
                         const pathfinding_settings &settings,
                         PathfindingFlags p_special ) const;
+        // The straight route from f to t if it has nothing special on it and nothing to avoid,
+        // otherwise an empty vector.
+        std::vector<tripoint_bub_ms> unobstructed_straight_route( const tripoint_bub_ms &f,
+                const tripoint_bub_ms &t,
+                const std::function<bool( const tripoint_bub_ms & )> &avoid ) const;
+        // The flow field of target and settings, if enough routes to it were asked for this
+        // turn to make working it out worth it.
+        const path_flow_field *get_path_flow_field( const pathfinding_target &target,
+                const pathfinding_settings &settings ) const;
     public:
 
         // Vehicles: Common to 2D and 3D
@@ -1593,12 +1641,15 @@ class map
 
         // Scent propagation helpers
         /**
-         * Build the map of scent-resistant tiles.
+         * Build the map of scent-resistant terrain and furniture.
          * Should be way faster than if done in `game.cpp` using public map functions.
          */
         void scent_blockers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &blocks_scent,
                              std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &reduces_scent,
-                             const point_bub_ms &min, const point_bub_ms &max );
+                             const point_bub_ms &min, const point_bub_ms &max ) const;
+        /** Mark the tiles where vehicle obstacles and open doors reduce scent. */
+        void vehicle_scent_reducers( std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> &reduces_scent,
+                                     const point_bub_ms &min, const point_bub_ms &max );
 
         // Computers
         computer *computer_at( const tripoint_bub_ms &p );
@@ -1911,6 +1962,9 @@ class map
         bool build_floor_cache( int zlev );
         // We want this visible in `game`, because we want it built earlier in the turn than the rest
         void build_floor_caches();
+        // Makes the next lightmap of this level cast the light of all bulk light sources again,
+        // instead of only around the ones that changed.
+        void clear_bulk_light( int zlev );
         void seen_cache_process_ledges( array_of_grids_of<float> &seen_caches,
                                         const array_of_grids_of<const bool> &floor_caches,
                                         const std::optional<tripoint_bub_ms> &override_p ) const;
@@ -2133,6 +2187,8 @@ class map
         mutable std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        // Flow fields of the targets routed to recently, the most recently used first
+        mutable std::vector<std::unique_ptr<path_flow_field>> path_flow_fields;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
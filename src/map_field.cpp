@@ -443,58 +443,67 @@ void map::process_fields_in_submap( submap *const current_submap,
         &( *fd_null )
     };
 
-    // Loop through all tiles in this submap indicated by current_submap
-    for( locx = 0; locx < SEEX; locx++ ) {
-        for( locy = 0; locy < SEEY; locy++ ) {
-            // Get a reference to the field variable from the submap;
-            // contains all the pointers to the real field effects.
-            field &curfield = current_submap->get_field( { static_cast<int>( locx ), static_cast<int>( locy ) } );
-
-            // when displayed_field_type == fd_null it means that `curfield` has no fields inside
-            // avoids instantiating (relatively) expensive map iterator
-            if( !curfield.displayed_field_type() ) {
-                continue;
-            }
-
-            // This is a translation from local coordinates to submap coordinates.
-            const tripoint_bub_ms p{sm_offset + rebase_rel( map_tile.pos() ), submap.z()};
+    // Loop through the tiles of this submap that hold fields. Fields spreading to tiles further
+    // along get processed in the same turn, as they always were.
+    std::bitset<SEEX *SEEY> &field_tiles = current_submap->field_tiles;
+    for( int index = 0; index < SEEX * SEEY; index++ ) {
+        if( !field_tiles[index] ) {
+            continue;
+        }
+        locx = index / SEEY;
+        locy = index % SEEY;
+        // Get a reference to the field variable from the submap;
+        // contains all the pointers to the real field effects.
+        field &curfield = current_submap->get_field( { static_cast<int>( locx ), static_cast<int>( locy ) } );
 
-            for( auto it = curfield.begin(); it != curfield.end(); ) {
-                // Iterating through all field effects in the submap's field.
-                field_entry &cur = it->second;
-                const int prev_intensity = cur.is_field_alive() ? cur.get_field_intensity() : 0;
+        // when displayed_field_type == fd_null it means that `curfield` has no fields inside
+        // avoids instantiating (relatively) expensive map iterator
+        if( !curfield.displayed_field_type() ) {
+            field_tiles.reset( index );
+            continue;
+        }
 
-                pd.cur_fd_type_id = cur.get_field_type();
-                pd.cur_fd_type = &( *pd.cur_fd_type_id );
+        // This is a translation from local coordinates to submap coordinates.
+        const tripoint_bub_ms p{sm_offset + rebase_rel( map_tile.pos() ), submap.z()};
 
-                // The field might have been killed by processing a neighbor field
-                if( prev_intensity == 0 ) {
-                    on_field_modified( p, *pd.cur_fd_type );
-                    --current_submap->field_count;
-                    curfield.remove_field( it++ );
-                    continue;
-                }
+        for( auto it = curfield.begin(); it != curfield.end(); ) {
+            // Iterating through all field effects in the submap's field.
+            field_entry &cur = it->second;
+            const int prev_intensity = cur.is_field_alive() ? cur.get_field_intensity() : 0;
 
-                // Don't process "newborn" fields. This gives the player time to run if they need to.
-                if( cur.get_field_age() == 0_turns ) {
-                    cur.do_decay();
-                    if( !cur.is_field_alive() || cur.get_field_intensity() != prev_intensity ) {
-                        on_field_modified( p, *pd.cur_fd_type );
-                    }
-                    ++it;
-                    continue;
-                }
+            pd.cur_fd_type_id = cur.get_field_type();
+            pd.cur_fd_type = &( *pd.cur_fd_type_id );
 
-                for( const FieldProcessorPtr &proc : pd.cur_fd_type->get_processors() ) {
-                    proc( p, cur, pd );
-                }
+            // The field might have been killed by processing a neighbor field
+            if( prev_intensity == 0 ) {
+                on_field_modified( p, *pd.cur_fd_type );
+                --current_submap->field_count;
+                curfield.remove_field( it++ );
+                continue;
+            }
 
+            // Don't process "newborn" fields. This gives the player time to run if they need to.
+            if( cur.get_field_age() == 0_turns ) {
                 cur.do_decay();
                 if( !cur.is_field_alive() || cur.get_field_intensity() != prev_intensity ) {
                     on_field_modified( p, *pd.cur_fd_type );
                 }
                 ++it;
+                continue;
             }
+
+            for( const FieldProcessorPtr &proc : pd.cur_fd_type->get_processors() ) {
+                proc( p, cur, pd );
+            }
+
+            cur.do_decay();
+            if( !cur.is_field_alive() || cur.get_field_intensity() != prev_intensity ) {
+                on_field_modified( p, *pd.cur_fd_type );
+            }
+            ++it;
+        }
+        if( curfield.field_count() == 0 ) {
+            field_tiles.reset( index );
         }
     }
     sblk.commit_modifications();
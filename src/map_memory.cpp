@@ -1,12 +1,20 @@
 #include <algorithm>
+#include <condition_variable>
 #include <cstddef>
+#include <deque>
 #include <exception>
 #include <functional>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <ostream>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "cached_options.h"
 #include "cata_assert.h"
@@ -17,11 +25,17 @@
 #include "debug.h"
 #include "filesystem.h"
 #include "game_constants.h"
+#include "json_loader.h"
 #include "map_memory.h"
+#include "options.h"
 #include "path_info.h"
 #include "string_formatter.h"
 #include "translations.h"
 
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
 const memorized_tile mm_submap::default_tile = {};
 
 static constexpr int MM_SIZE = MAPSIZE * 2;
@@ -57,6 +71,110 @@ struct reg_coord_pair {
     }
 };
 
+/**
+ * Reads the regions ahead of the avatar, on a thread of its own. Regions get parsed on the main
+ * thread only, as that goes through the global string_id tables; this thread only reads bytes.
+ */
+struct map_memory::region_io {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::pair<tripoint, cata_path>> to_read;
+    std::optional<tripoint> reading;
+    // Contents of the regions read, null if there is no such file
+    std::map<tripoint, std::shared_ptr<const std::string>> read;
+    bool stopping = false;
+    std::thread worker;
+
+    region_io() : worker( [this]() {
+        run();
+    } ) {}
+    region_io( const region_io & ) = delete;
+    region_io &operator=( const region_io & ) = delete;
+
+    ~region_io() {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock( mutex );
+        while( true ) {
+            cv.wait( lock, [this]() {
+                return stopping || !to_read.empty();
+            } );
+            if( stopping ) {
+                return;
+            }
+            const std::pair<tripoint, cata_path> job = to_read.front();
+            to_read.pop_front();
+            reading = job.first;
+            lock.unlock();
+            std::shared_ptr<const std::string> contents;
+            try {
+                if( file_exist( job.second ) ) {
+                    contents = std::make_shared<const std::string>(
+                                   read_entire_file( job.second.get_unrelative_path() ) );
+                }
+            } catch( const std::exception & ) {
+                // Leave it to be read when it's needed, and complain then
+                lock.lock();
+                reading.reset();
+                cv.notify_all();
+                continue;
+            }
+            lock.lock();
+            read[job.first] = contents;
+            reading.reset();
+            cv.notify_all();
+        }
+    }
+
+    /** Replace the regions to read ahead of time, dropping what was read but not needed. */
+    void prefetch( const std::vector<std::pair<tripoint, cata_path>> &regions ) {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            std::map<tripoint, std::shared_ptr<const std::string>> still_wanted;
+            to_read.clear();
+            for( const std::pair<tripoint, cata_path> &job : regions ) {
+                const auto it = read.find( job.first );
+                if( it != read.end() ) {
+                    still_wanted.insert( *it );
+                } else if( reading != job.first ) {
+                    to_read.push_back( job );
+                }
+            }
+            read.swap( still_wanted );
+        }
+        cv.notify_all();
+    }
+
+    /**
+     * Take a region that was read ahead of time.
+     * @returns nullopt if the file has to be read.
+     */
+    std::optional<std::shared_ptr<const std::string>> take( const tripoint &reg ) {
+        std::unique_lock<std::mutex> lock( mutex );
+        to_read.erase( std::remove_if( to_read.begin(), to_read.end(),
+        [&reg]( const std::pair<tripoint, cata_path> &job ) {
+            return job.first == reg;
+        } ), to_read.end() );
+        cv.wait( lock, [this, &reg]() {
+            return reading != reg;
+        } );
+        const auto it = read.find( reg );
+        if( it == read.end() ) {
+            return std::nullopt;
+        }
+        std::shared_ptr<const std::string> ret = it->second;
+        read.erase( it );
+        return ret;
+    }
+};
+
 mm_submap::mm_submap( bool make_valid ) : valid( make_valid ) {}
 
 bool mm_submap::is_empty() const
@@ -69,6 +187,16 @@ bool mm_submap::is_valid() const
     return valid;
 }
 
+bool mm_submap::is_dirty() const
+{
+    return dirty;
+}
+
+void mm_submap::mark_saved()
+{
+    dirty = false;
+}
+
 const memorized_tile &mm_submap::get_tile( const point_sm_ms &p ) const
 {
     if( tiles.empty() ) {
@@ -77,14 +205,41 @@ const memorized_tile &mm_submap::get_tile( const point_sm_ms &p ) const
     return tiles[p.y() * SEEX + p.x()];
 }
 
+// Short decoration ids are stored inside the string, longer ones take an allocation of their own
+static size_t dec_id_bytes( const std::string &dec_id )
+{
+    static const size_t inline_capacity = std::string().capacity();
+    return dec_id.capacity() > inline_capacity ? dec_id.capacity() + 1 : 0;
+}
+
 void mm_submap::set_tile( const point_sm_ms &p, const memorized_tile &value )
 {
+    const size_t old_bytes = tile_bytes();
     if( tiles.empty() ) {
         // call 'reserve' first to force allocation of exact size
         tiles.reserve( SEEX * SEEY );
         tiles.resize( SEEX * SEEY, default_tile );
     }
-    tiles[p.y() * SEEX + p.x()] = value;
+    memorized_tile &tile = tiles[p.y() * SEEX + p.x()];
+    if( tile != value ) {
+        dec_bytes -= dec_id_bytes( tile.dec_id );
+        tile = value;
+        dec_bytes += dec_id_bytes( tile.dec_id );
+        dirty = true;
+    }
+    if( counted_bytes ) {
+        *counted_bytes = *counted_bytes - old_bytes + tile_bytes();
+    }
+}
+
+size_t mm_submap::tile_bytes() const
+{
+    return tiles.capacity() * sizeof( memorized_tile ) + dec_bytes;
+}
+
+void mm_submap::count_bytes_in( size_t *total )
+{
+    counted_bytes = total;
 }
 
 mm_region::mm_region() : submaps( nullptr ) {}
@@ -102,6 +257,19 @@ bool mm_region::is_empty() const
     return true;
 }
 
+bool mm_region::is_dirty() const
+{
+    for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
+        // NOLINTNEXTLINE(modernize-loop-convert)
+        for( size_t x  = 0; x < MM_REG_SIZE; x++ ) {
+            if( submaps[x][y]->is_dirty() ) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 const std::string &memorized_tile::get_ter_id() const
 {
     return ter_id.str();
@@ -203,6 +371,60 @@ map_memory::map_memory()
     clear_cache();
 }
 
+map_memory::~map_memory() = default;
+
+map_memory_stats map_memory::get_stats() const
+{
+    map_memory_stats ret = stats;
+    ret.resident = resident_regions.size();
+    ret.resident_bytes = resident_bytes;
+    ret.pending = evicted.size();
+    for( const std::pair<const tripoint, std::shared_ptr<const std::string>> &it : evicted ) {
+        ret.pending_bytes += it.second->size();
+    }
+    return ret;
+}
+
+size_t map_memory::max_resident_bytes()
+{
+    return static_cast<size_t>( get_option<int>( "MAP_MEMORY_RESIDENT_MB" ) ) * 1024 * 1024;
+}
+
+// Roughly how much memory a region takes while it's resident
+static size_t region_bytes( const mm_region &mmr )
+{
+    // A submap and its entry in the map, give or take the allocator's bookkeeping. Most of the
+    // regions above and below the avatar never get anything memorized, they stay this small.
+    static constexpr size_t empty_submap_bytes = sizeof( mm_submap ) +
+            sizeof( std::pair<const tripoint_abs_sm, shared_ptr_fast<mm_submap>> ) + 64;
+
+    size_t ret = 0;
+    for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
+        for( size_t x = 0; x < MM_REG_SIZE; x++ ) {
+            ret += empty_submap_bytes + mmr.submaps[x][y]->tile_bytes();
+        }
+    }
+    return ret;
+}
+
+// Stops counting the submaps of a region that's no longer resident
+static void stop_counting( mm_region &mmr )
+{
+    for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
+        for( size_t x = 0; x < MM_REG_SIZE; x++ ) {
+            mmr.submaps[x][y]->count_bytes_in( nullptr );
+        }
+    }
+}
+
+map_memory::region_io &map_memory::get_io()
+{
+    if( !io ) {
+        io = std::make_unique<region_io>();
+    }
+    return *io;
+}
+
 const memorized_tile &map_memory::get_tile( const tripoint_abs_ms &pos ) const
 {
     const coord_pair p( pos );
@@ -291,9 +513,11 @@ bool map_memory::prepare_region( const tripoint_abs_ms &p1, const tripoint_abs_m
 
     dbg( D_INFO ) << "Preparing memory map for area: pos: " << sm_pos << " size: " << sm_size;
 
+    const tripoint_abs_sm old_cache_pos = cache_pos;
     cache_pos = sm_pos;
     cache_size = sm_size.raw();
     cached.clear();
+    last_used++;
     // Loop through each z-level in vision range
     for( int z = std::max( sm_pos.z() - fov_3d_z_range, -OVERMAP_DEPTH );
          z <= std::min( sm_pos.z() + fov_3d_z_range, OVERMAP_HEIGHT ); z++ ) {
@@ -306,13 +530,102 @@ bool map_memory::prepare_region( const tripoint_abs_ms &p1, const tripoint_abs_m
             }
         }
     }
+    evict_regions();
+    prefetch_ahead( old_cache_pos, cache_pos );
     return true;
 }
 
+void map_memory::prefetch_ahead( const tripoint_abs_sm &old_pos, const tripoint_abs_sm &new_pos )
+{
+    if( test_mode || old_pos == tripoint_abs_sm::invalid || old_pos.z() != new_pos.z() ) {
+        return;
+    }
+    const auto sign = []( int v ) {
+        return ( v > 0 ) - ( v < 0 );
+    };
+    const point heading( sign( new_pos.x() - old_pos.x() ), sign( new_pos.y() - old_pos.y() ) );
+    if( heading == point::zero ) {
+        return;
+    }
+    // The cache moved a region further along, the regions it would cover then aren't in
+    // memory yet, unless the avatar has been there recently.
+    const tripoint_rel_sm lead( heading.x * MM_REG_SIZE, heading.y * MM_REG_SIZE, 0 );
+    const tripoint reg_min = reg_coord_pair( new_pos + lead ).reg;
+    const tripoint reg_max = reg_coord_pair( new_pos + lead + tripoint( cache_size, 0 ) ).reg;
+    const cata_path dirname = find_mm_dir();
+    std::vector<std::pair<tripoint, cata_path>> regions;
+    for( int z = std::max( new_pos.z() - fov_3d_z_range, -OVERMAP_DEPTH );
+         z <= std::min( new_pos.z() + fov_3d_z_range, OVERMAP_HEIGHT ); z++ ) {
+        for( int y = reg_min.y; y <= reg_max.y; y++ ) {
+            for( int x = reg_min.x; x <= reg_max.x; x++ ) {
+                const tripoint reg( x, y, z );
+                if( resident_regions.count( reg ) == 0 && evicted.count( reg ) == 0 ) {
+                    regions.emplace_back( reg, find_region_path( dirname, reg ) );
+                }
+            }
+        }
+    }
+    get_io().prefetch( regions );
+}
+
+void map_memory::evict_regions()
+{
+    const size_t limit = max_resident_bytes();
+    if( resident_bytes <= limit ) {
+        return;
+    }
+    // Regions the cache was just filled from stay, however much memory they take
+    std::vector<std::pair<int64_t, tripoint>> candidates;
+    for( const std::pair<const tripoint, int64_t> &it : resident_regions ) {
+        if( it.second < last_used ) {
+            candidates.emplace_back( it.second, it.first );
+        }
+    }
+    std::sort( candidates.begin(), candidates.end() );
+    for( const std::pair<int64_t, tripoint> &candidate : candidates ) {
+        if( resident_bytes <= limit ) {
+            break;
+        }
+        evict_region( candidate.second );
+    }
+}
+
+void map_memory::evict_region( const tripoint &reg )
+{
+    const tripoint_abs_sm regp_sm( mmr_to_sm_copy( reg ) );
+    mm_region mmr;
+    for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
+        for( size_t x = 0; x < MM_REG_SIZE; x++ ) {
+            const auto it = submaps.find( regp_sm + tripoint( x, y, 0 ) );
+            cata_assert( it != submaps.end() );
+            mmr.submaps[x][y] = it->second;
+            submaps.erase( it );
+        }
+    }
+    resident_regions.erase( reg );
+    resident_bytes -= region_bytes( mmr );
+    stop_counting( mmr );
+    stats.evictions++;
+
+    dbg( D_INFO ) << "Evicted mm_region " << reg << " [" << regp_sm << "]";
+
+    // Unchanged regions are on disk already, or still kept from an earlier eviction
+    if( mmr.is_empty() || !mmr.is_dirty() ) {
+        return;
+    }
+    evicted[reg] = std::make_shared<const std::string>(
+    serialize_wrapper( [&]( JsonOut & jsout ) {
+        mmr.serialize( jsout );
+    } ) );
+    stats.serialized++;
+}
+
 shared_ptr_fast<mm_submap> map_memory::fetch_submap( const tripoint_abs_sm &sm_pos )
 {
     shared_ptr_fast<mm_submap> sm = find_submap( sm_pos );
     if( sm ) {
+        stats.hits++;
+        resident_regions[reg_coord_pair( sm_pos ).reg] = last_used;
         return sm;
     }
     sm = load_submap( sm_pos );
@@ -322,27 +635,42 @@ shared_ptr_fast<mm_submap> map_memory::fetch_submap( const tripoint_abs_sm &sm_p
     return allocate_submap( sm_pos );
 }
 
+shared_ptr_fast<mm_submap> map_memory::adopt_region( const tripoint &reg, mm_region &mmr,
+        const tripoint_abs_sm &sm_pos )
+{
+    shared_ptr_fast<mm_submap> ret;
+    for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
+        for( size_t x = 0; x < MM_REG_SIZE; x++ ) {
+            const tripoint_abs_sm pos( mmr_to_sm_copy( reg ) + tripoint( x, y, 0 ) );
+            shared_ptr_fast<mm_submap> &sm = mmr.submaps[x][y];
+            if( pos == sm_pos ) {
+                ret = sm;
+            }
+            sm->count_bytes_in( &resident_bytes );
+            submaps.emplace( pos, sm );
+        }
+    }
+    resident_regions[reg] = last_used;
+    resident_bytes += region_bytes( mmr );
+    return ret;
+}
+
 shared_ptr_fast<mm_submap> map_memory::allocate_submap( const tripoint_abs_sm &sm_pos )
 {
     // Since all save/load operations are done on regions of submaps,
     // we need to allocate the whole region at once.
-    shared_ptr_fast<mm_submap> ret;
     tripoint reg = reg_coord_pair( sm_pos ).reg;
 
     dbg( D_INFO ) << "Allocated mm_region " << reg << " [" << mmr_to_sm_copy( reg ) << "]";
 
+    mm_region mmr;
     for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
         for( size_t x = 0; x < MM_REG_SIZE; x++ ) {
-            const tripoint_abs_sm pos( mmr_to_sm_copy( reg ) + tripoint( x, y, 0 ) );
-            shared_ptr_fast<mm_submap> sm = make_shared_fast<mm_submap>();
-            if( pos == sm_pos ) {
-                ret = sm;
-            }
-            submaps.insert( std::make_pair( pos, sm ) );
+            mmr.submaps[x][y] = make_shared_fast<mm_submap>();
         }
     }
-
-    return ret;
+    stats.allocations++;
+    return adopt_region( reg, mmr, sm_pos );
 }
 
 shared_ptr_fast<mm_submap> map_memory::find_submap( const tripoint_abs_sm &sm_pos )
@@ -357,11 +685,23 @@ shared_ptr_fast<mm_submap> map_memory::find_submap( const tripoint_abs_sm &sm_po
 
 shared_ptr_fast<mm_submap> map_memory::load_submap( const tripoint_abs_sm &sm_pos )
 {
-    if( test_mode ) {
+    const reg_coord_pair p( sm_pos );
+
+    // Evicted regions waiting to be saved, and ones read ahead of time, come from memory
+    bool prefetched = false;
+    std::optional<std::shared_ptr<const std::string>> known;
+    const auto evicted_it = evicted.find( p.reg );
+    if( evicted_it != evicted.end() ) {
+        known = evicted_it->second;
+    } else if( io ) {
+        known = io->take( p.reg );
+        prefetched = known.has_value();
+    }
+
+    if( test_mode && !known ) {
         return nullptr;
     }
 
-    const reg_coord_pair p( sm_pos );
     const cata_path path = find_region_path( find_mm_dir(), p.reg );
 
     mm_region mmr;
@@ -370,7 +710,13 @@ shared_ptr_fast<mm_submap> map_memory::load_submap( const tripoint_abs_sm &sm_po
     };
 
     try {
-        if( !read_from_file_optional_json( path, loader ) ) {
+        if( known ) {
+            if( !*known ) {
+                // Region not found
+                return nullptr;
+            }
+            loader( json_loader::from_string( **known ) );
+        } else if( !read_from_file_optional_json( path, loader ) ) {
             // Region not found
             return nullptr;
         }
@@ -382,20 +728,18 @@ shared_ptr_fast<mm_submap> map_memory::load_submap( const tripoint_abs_sm &sm_po
 
     dbg( D_INFO ) << "Loaded mm_region " << p.reg << " [" << mmr_to_sm_copy( p.reg ) << "]";
 
-    shared_ptr_fast<mm_submap> ret;
-
+    // It's on disk already, or in evicted until the next save
     for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
         for( size_t x = 0; x < MM_REG_SIZE; x++ ) {
-            const tripoint_abs_sm pos( mmr_to_sm_copy( p.reg ) + tripoint( x, y, 0 ) );
-            shared_ptr_fast<mm_submap> &sm = mmr.submaps[x][y];
-            if( pos == sm_pos ) {
-                ret = sm;
-            }
-            submaps.emplace( pos, sm );
+            mmr.submaps[x][y]->mark_saved();
         }
     }
-
-    return ret;
+    if( prefetched ) {
+        stats.prefetched++;
+    } else {
+        stats.loads++;
+    }
+    return adopt_region( p.reg, mmr, sm_pos );
 }
 
 static mm_submap null_mz_submap;
@@ -433,6 +777,7 @@ void map_memory::load( const tripoint_abs_ms &pos )
     dbg( D_INFO ) << "[LOAD] Loading memory map around " << p.sm << ". Loading submaps within " << start
                   << "->" << start + tripoint( MM_SIZE, MM_SIZE, 0 );
     clear_cache();
+    last_used++;
     for( int dy = 0; dy < MM_SIZE; dy++ ) {
         for( int dx = 0; dx < MM_SIZE; dx++ ) {
             fetch_submap( start + tripoint_rel_sm( dx, dy, 0 ) );
@@ -451,6 +796,28 @@ bool map_memory::save( const tripoint_abs_ms &pos )
 
     dbg( D_INFO ) << "N submaps before save: " << submaps.size();
 
+    bool result = true;
+
+    // Evicted regions go first, the ones in memory may be newer
+    for( auto it = evicted.begin(); it != evicted.end(); ) {
+        const tripoint &regp = it->first;
+        const std::string descr = string_format(
+                                      _( "memory map region for (%d,%d,%d)" ),
+                                      regp.x, regp.y, regp.z
+                                  );
+        const std::string &contents = *it->second;
+        const bool res = write_to_file( find_region_path( dirname, regp ),
+        [&contents]( std::ostream & fout ) {
+            fout << contents;
+        }, descr.c_str() );
+        if( res ) {
+            it = evicted.erase( it );
+        } else {
+            ++it;
+        }
+        result = result & res;
+    }
+
     // Since mm_submaps are always allocated in regions,
     // we are certain that each region will be filled.
     std::map<tripoint, mm_region> regions;
@@ -466,12 +833,11 @@ bool map_memory::save( const tripoint_abs_ms &pos )
     dbg( D_INFO ) << "[SAVE] Saving memory map around " << sm_center << ". Keeping submaps within " <<
                   rect_keep.p_min << "->" << rect_keep.p_max;
 
-    bool result = true;
-
     for( auto &it : regions ) {
         const tripoint &regp = it.first;
         mm_region &reg = it.second;
-        if( !reg.is_empty() ) {
+        // Regions that didn't change since they were loaded or last saved are already on disk
+        if( reg.is_dirty() && !reg.is_empty() ) {
             const cata_path path = find_region_path( dirname, regp );
             const std::string descr = string_format(
                                           _( "memory map region for (%d,%d,%d)" ),
@@ -486,6 +852,13 @@ bool map_memory::save( const tripoint_abs_ms &pos )
             };
 
             const bool res = write_to_file( path, writer, descr.c_str() );
+            if( res ) {
+                for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
+                    for( size_t x = 0; x < MM_REG_SIZE; x++ ) {
+                        reg.submaps[x][y]->mark_saved();
+                    }
+                }
+            }
             result = result & res;
         }
         const tripoint_abs_sm regp_sm( mmr_to_sm_copy( regp ) );
@@ -505,10 +878,17 @@ bool map_memory::save( const tripoint_abs_ms &pos )
             }
         } else {
             dbg( D_INFO ) << "Dropping mm_region " << regp << " [" << regp_sm << "]";
+            resident_regions.erase( regp );
+            resident_bytes -= region_bytes( reg );
+            stop_counting( reg );
         }
     }
 
     dbg( D_INFO ) << "[SAVE] Done.";
+    dbg( D_INFO ) << "Map memory so far: " << stats.hits << " submaps in memory, " <<
+                  stats.prefetched << " regions read ahead, " << stats.loads << " read when needed, " <<
+                  stats.allocations << " allocated, " << stats.evictions << " evicted, " <<
+                  stats.serialized << " changed when evicted";
     dbg( D_INFO ) << "N submaps after save: " << submaps.size();
 
     return result;
@@ -2,10 +2,13 @@
 #ifndef CATA_SRC_MAP_MEMORY_H
 #define CATA_SRC_MAP_MEMORY_H
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "coordinates.h"
@@ -65,10 +68,18 @@ struct mm_submap {
         bool is_empty() const;
         // @returns true if mm_submap is valid, i.e. not returned from an uninitialized region.
         bool is_valid() const;
+        // @returns true if mm_submap changed since it was last written to disk.
+        bool is_dirty() const;
+        void mark_saved();
 
         const memorized_tile &get_tile( const point_sm_ms &p ) const;
         void set_tile( const point_sm_ms &p, const memorized_tile &value );
 
+        // @returns roughly how much memory the tiles take, decoration ids included.
+        size_t tile_bytes() const;
+        // Keep @p total up to date with changes to tile_bytes(), nullptr to stop.
+        void count_bytes_in( size_t *total );
+
         void serialize( JsonOut &jsout ) const;
         void deserialize( int version, const JsonArray &ja );
 
@@ -77,6 +88,13 @@ struct mm_submap {
         std::vector<memorized_tile> tiles; // holds either 0 or SEEX*SEEY elements
         // NOLINTNEXTLINE(cata-serialize)
         bool valid = true;
+        // NOLINTNEXTLINE(cata-serialize)
+        bool dirty = false;
+        // Memory taken by decoration ids too long to be stored inside the string
+        // NOLINTNEXTLINE(cata-serialize)
+        size_t dec_bytes = 0;
+        // NOLINTNEXTLINE(cata-serialize)
+        size_t *counted_bytes = nullptr;
 };
 
 /**
@@ -90,13 +108,40 @@ struct mm_region {
     mm_region();
 
     bool is_empty() const;
+    bool is_dirty() const;
 
     void serialize( JsonOut &jsout ) const;
     void deserialize( const JsonValue &ja );
 };
 
+/** How map memory regions were found when they were needed. */
+struct map_memory_stats {
+    // Submaps that were already in memory
+    int hits = 0;
+    // Regions that had been read from disk ahead of time
+    int prefetched = 0;
+    // Regions that had to be read from disk when they were needed
+    int loads = 0;
+    // Regions that weren't on disk and were allocated empty
+    int allocations = 0;
+    // Regions dropped from memory to stay within the limit, and how many of them had changed
+    // and were serialized for save()
+    int evictions = 0;
+    int serialized = 0;
+    // Changed regions that were dropped, waiting for save() to write them, and their size
+    int pending = 0;
+    size_t pending_bytes = 0;
+    // Regions currently in memory, and roughly how much memory they take
+    int resident = 0;
+    size_t resident_bytes = 0;
+};
+
 /**
  * Manages map tiles memorized by the avatar.
+ *
+ * Memory is kept in regions of MM_REG_SIZE x MM_REG_SIZE submaps. Only so many of them stay in
+ * memory, the least recently used ones are dropped. Those that changed are kept serialized until
+ * save() writes them, so map memory on disk never gets ahead of the rest of the save.
  */
 class map_memory
 {
@@ -114,6 +159,7 @@ class map_memory
 
     public:
         map_memory();
+        ~map_memory();
 
         // @returns true if map memory has been loaded
         bool is_valid() const;
@@ -121,7 +167,10 @@ class map_memory
         /** Load memorized submaps around given global map square pos. */
         void load( const tripoint_abs_ms &pos );
 
-        /** Save memorized submaps to disk, drop ones far from given global map square pos. */
+        /**
+         * Save memorized submaps that changed to disk, drop ones far from given global map
+         * square pos.
+         */
         bool save( const tripoint_abs_ms &pos );
 
         /**
@@ -166,8 +215,25 @@ class map_memory
          */
         void clear_tile_decoration( const tripoint_abs_ms &pos, std::string_view prefix = "" );
 
+        map_memory_stats get_stats() const;
+
+        /** How much memory the regions may take, from the MAP_MEMORY_RESIDENT_MB option. */
+        static size_t max_resident_bytes();
+
     private:
+        struct region_io;
+
         std::map<tripoint_abs_sm, shared_ptr_fast<mm_submap>> submaps;
+        // Regions in memory, and the last time they were prepared for rendering.
+        std::unordered_map<tripoint, int64_t> resident_regions;
+        int64_t last_used = 0;
+        // Roughly how much memory the resident regions take, their submaps keep it up to date.
+        size_t resident_bytes = 0;
+        // Changed regions that were evicted, serialized, until save() writes them.
+        std::map<tripoint, std::shared_ptr<const std::string>> evicted;
+        // Reads the regions ahead of the avatar, started when first needed.
+        std::unique_ptr<region_io> io;
+        map_memory_stats stats;
 
         mutable std::map<int, std::vector<shared_ptr_fast<mm_submap>>> cached;
         tripoint_abs_sm cache_pos;
@@ -181,6 +247,17 @@ class map_memory
         shared_ptr_fast<mm_submap> load_submap( const tripoint_abs_sm &sm_pos );
         /** Allocate empty submap. @returns the submap. */
         shared_ptr_fast<mm_submap> allocate_submap( const tripoint_abs_sm &sm_pos );
+        /** Add a loaded or allocated region to the resident ones. @returns the submap at sm_pos. */
+        shared_ptr_fast<mm_submap> adopt_region( const tripoint &reg, mm_region &mmr,
+                const tripoint_abs_sm &sm_pos );
+
+        region_io &get_io();
+        /** Start reading the regions next to the cache, on the side the avatar is heading for. */
+        void prefetch_ahead( const tripoint_abs_sm &old_pos, const tripoint_abs_sm &new_pos );
+        /** Drop the least recently used regions outside of the cache until within the limit. */
+        void evict_regions();
+        /** Drop a region, keeping it serialized for save() if it changed. */
+        void evict_region( const tripoint &reg );
 
         /** Get submap from within the cache */
         //@{
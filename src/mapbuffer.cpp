@@ -1,34 +1,48 @@
 #include "mapbuffer.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <exception>
 #include <filesystem>
 #include <functional>
-#include <set>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "cata_path.h"
+#include "cata_scope_helpers.h"
 #include "cata_utility.h"
 #include "debug.h"
 #include "filesystem.h"
 #include "flexbuffer_json.h"
 #include "input.h"
 #include "json.h"
+#include "json_loader.h"
 #include "map.h"
 #include "output.h"
 #include "overmapbuffer.h"
 #include "path_info.h"
 #include "point.h"
 #include "popup.h"
+#include "quad_file.h"
 #include "string_formatter.h"
 #include "submap.h"
 #include "translations.h"
 #include "type_id.h"
 #include "ui_manager.h"
 
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
 #define dbg(x) DebugLog((x),D_MAP) << __FILE__ << ":" << __LINE__ << ": "
 
 class game;
@@ -56,31 +70,64 @@ mapbuffer MAPBUFFER;
 mapbuffer::mapbuffer() = default;
 mapbuffer::~mapbuffer() = default;
 
+bool mapbuffer::quad::empty() const
+{
+    return std::all_of( submaps.begin(), submaps.end(), []( const std::unique_ptr<submap> &sm ) {
+        return sm == nullptr;
+    } );
+}
+
+size_t mapbuffer::quad_index( const tripoint_abs_sm &p )
+{
+    const point_rel_sm local = p.xy() - project_to<coords::sm>( project_to<coords::omt>( p ) ).xy();
+    return local.x() + 2 * local.y();
+}
+
+std::unique_ptr<submap> *mapbuffer::find_slot( const tripoint_abs_sm &p )
+{
+    const auto it = quads.find( project_to<coords::omt>( p ) );
+    if( it == quads.end() ) {
+        return nullptr;
+    }
+    return &it->second.submaps[quad_index( p )];
+}
+
 void mapbuffer::clear()
 {
-    submaps.clear();
+    quads.clear();
+    num_submaps = 0;
 }
 
 void mapbuffer::clear_outside_reality_bubble()
 {
     map &here = get_map();
-    auto it = submaps.begin();
-    while( it != submaps.end() ) {
-        if( here.inbounds( it->first ) ) {
-            ++it;
+    auto it = quads.begin();
+    while( it != quads.end() ) {
+        const tripoint_abs_sm base = project_to<coords::sm>( it->first );
+        for( size_t i = 0; i < it->second.submaps.size(); ++i ) {
+            std::unique_ptr<submap> &sm = it->second.submaps[i];
+            if( sm && !here.inbounds( base + point( i % 2, i / 2 ) ) ) {
+                sm.reset();
+                num_submaps--;
+            }
+        }
+        if( it->second.empty() ) {
+            it = quads.erase( it );
         } else {
-            it = submaps.erase( it );
+            ++it;
         }
     }
 }
 
 bool mapbuffer::add_submap( const tripoint_abs_sm &p, std::unique_ptr<submap> &sm )
 {
-    if( submaps.count( p ) ) {
+    std::unique_ptr<submap> &slot = quads[project_to<coords::omt>( p )].submaps[quad_index( p )];
+    if( slot ) {
         return false;
     }
 
-    submaps[p] = std::move( sm );
+    slot = std::move( sm );
+    num_submaps++;
 
     return true;
 }
@@ -99,12 +146,16 @@ bool mapbuffer::add_submap( const tripoint_abs_sm &p, submap *sm )
 
 void mapbuffer::remove_submap( const tripoint_abs_sm &addr )
 {
-    auto m_target = submaps.find( addr );
-    if( m_target == submaps.end() ) {
+    const auto it = quads.find( project_to<coords::omt>( addr ) );
+    if( it == quads.end() || it->second.submaps[quad_index( addr )] == nullptr ) {
         debugmsg( "Tried to remove non-existing submap %s", addr.to_string() );
         return;
     }
-    submaps.erase( m_target );
+    it->second.submaps[quad_index( addr )].reset();
+    num_submaps--;
+    if( it->second.empty() ) {
+        quads.erase( it );
+    }
 }
 
 submap *mapbuffer::lookup_submap( const tripoint_abs_sm &p )
@@ -112,8 +163,8 @@ submap *mapbuffer::lookup_submap( const tripoint_abs_sm &p )
     dbg( D_INFO ) << "mapbuffer::lookup_submap( x[" << p.x() << "], y[" << p.y() << "], z["
                   << p.z() << "])";
 
-    const auto iter = submaps.find( p );
-    if( iter == submaps.end() ) {
+    std::unique_ptr<submap> *slot = find_slot( p );
+    if( slot == nullptr || *slot == nullptr ) {
         try {
             return unserialize_submaps( p );
         } catch( const std::exception &err ) {
@@ -122,14 +173,14 @@ submap *mapbuffer::lookup_submap( const tripoint_abs_sm &p )
         return nullptr;
     }
 
-    return iter->second.get();
+    return slot->get();
 }
 
 bool mapbuffer::submap_exists( const tripoint_abs_sm &p )
 {
     // Could so with a second check against a std::unordered_set<tripoint_abs_sm> of already checked existing but not loaded submaps before resorting to unserializing?
-    const auto iter = submaps.find( p );
-    if( iter == submaps.end() ) {
+    std::unique_ptr<submap> *slot = find_slot( p );
+    if( slot == nullptr || *slot == nullptr ) {
         try {
             return unserialize_submaps( p );
         } catch( const std::exception &err ) {
@@ -143,8 +194,8 @@ bool mapbuffer::submap_exists( const tripoint_abs_sm &p )
 
 bool mapbuffer::submap_exists_approx( const tripoint_abs_sm &p )
 {
-    const auto iter = submaps.find( p );
-    if( iter == submaps.end() ) {
+    std::unique_ptr<submap> *slot = find_slot( p );
+    if( slot == nullptr || *slot == nullptr ) {
         try {
             const tripoint_abs_omt om_addr = project_to<coords::omt>( p );
             const cata_path dirname = find_dirname( om_addr );
@@ -159,151 +210,219 @@ bool mapbuffer::submap_exists_approx( const tripoint_abs_sm &p )
     return true;
 }
 
+struct mapbuffer::quad_save_job {
+    cata_path dirname;
+    cata_path path;
+    // Submaps present in the buffer, in the order they're stored in the file.
+    std::vector<std::pair<tripoint_abs_sm, const submap *>> submaps;
+    // The quad reverted to uniform, its file only gets written to be removed right after.
+    bool remove_file = false;
+    // Serialized on the main thread, one per submap.
+    std::vector<quad_file::submap_json> json;
+    // Filled in by the writing thread.
+    std::exception_ptr error;
+};
+
 void mapbuffer::save( bool delete_after_save )
 {
     assure_dir_exist( PATH_INFO::world_base_save_path() / "maps" );
 
-    int num_saved_submaps = 0;
-    int num_total_submaps = submaps.size();
+    const int num_total_submaps = num_submaps;
 
     map &here = get_map();
 
     static_popup popup;
 
-    // A set of already-saved submaps, in global overmap coordinates.
-    std::set<tripoint_abs_omt> saved_submaps;
+    // Go through the quads in the order their files are laid out on disk, so files of the
+    // same segment directory get written together.
+    std::vector<tripoint_abs_omt> quads_to_save;
+    quads_to_save.reserve( quads.size() );
+    for( const auto &elem : quads ) {
+        quads_to_save.push_back( elem.first );
+    }
+    std::sort( quads_to_save.begin(), quads_to_save.end(),
+    []( const tripoint_abs_omt & lhs, const tripoint_abs_omt & rhs ) {
+        const tripoint_abs_seg lhs_seg = project_to<coords::seg>( lhs );
+        const tripoint_abs_seg rhs_seg = project_to<coords::seg>( rhs );
+        return std::make_tuple( lhs_seg.z(), lhs_seg.y(), lhs_seg.x(), lhs.y(), lhs.x() ) <
+               std::make_tuple( rhs_seg.z(), rhs_seg.y(), rhs_seg.x(), rhs.y(), rhs.x() );
+    } );
+
     std::list<tripoint_abs_sm> submaps_to_delete;
+    std::vector<quad_save_job> jobs;
+    for( const tripoint_abs_omt &om_addr : quads_to_save ) {
+        bool inside_reality_bubble = here.inbounds( om_addr );
+        // delete_on_save deletes everything, otherwise delete submaps
+        // outside the current map.
+        plan_quad_save( om_addr, submaps_to_delete, jobs,
+                        delete_after_save || !inside_reality_bubble );
+    }
+
+    // Quads that don't need a file count as saved right away.
+    int num_queued_submaps = 0;
+    for( const quad_save_job &job : jobs ) {
+        num_queued_submaps += job.submaps.size();
+    }
+    std::atomic<int> num_saved_submaps( num_total_submaps - num_queued_submaps );
+
+    // Items and vehicles reach into game state when serialized, so their json is built on
+    // this thread. Worker threads lay out the files around it and write them, while this
+    // thread serializes the next quads and keeps the ui alive.
+    std::mutex jobs_mutex;
+    std::condition_variable jobs_cv;
+    std::condition_variable written_cv;
+    // Jobs before this one have their json serialized.
+    size_t num_ready_jobs = 0;
+    size_t next_job = 0;
+    size_t num_written_jobs = 0;
+    bool all_ready = false;
+
+    const auto write_jobs = [&]() {
+        while( true ) {
+            size_t i = 0;
+            {
+                std::unique_lock<std::mutex> lock( jobs_mutex );
+                jobs_cv.wait( lock, [&]() {
+                    return all_ready || next_job < num_ready_jobs;
+                } );
+                if( next_job == num_ready_jobs ) {
+                    return;
+                }
+                i = next_job++;
+            }
+            quad_save_job &job = jobs[i];
+            try {
+                const std::string contents = quad_file::write( job.submaps, job.json );
+                // Goes through a temporary file, so a quad file is never left half written.
+                write_to_file( job.path, [&]( std::ostream & fout ) {
+                    fout << contents;
+                } );
+                if( job.remove_file ) {
+                    std::filesystem::remove( job.path.get_unrelative_path() );
+                }
+            } catch( ... ) {
+                job.error = std::current_exception();
+            }
+            job.json = std::vector<quad_file::submap_json>();
+            num_saved_submaps += job.submaps.size();
+            {
+                std::lock_guard<std::mutex> lock( jobs_mutex );
+                ++num_written_jobs;
+            }
+            written_cv.notify_one();
+        }
+    };
+
+    const unsigned int num_workers = std::min<size_t>( jobs.size(),
+                                     std::max( std::thread::hardware_concurrency(), 1u ) );
+    std::vector<std::thread> workers;
+    on_out_of_scope join_workers( [&]() {
+        {
+            std::lock_guard<std::mutex> lock( jobs_mutex );
+            all_ready = true;
+        }
+        jobs_cv.notify_all();
+        for( std::thread &worker : workers ) {
+            worker.join();
+        }
+    } );
+    workers.reserve( num_workers );
+    for( unsigned int i = 0; i < num_workers; ++i ) {
+        workers.emplace_back( write_jobs );
+    }
+
     static constexpr std::chrono::milliseconds update_interval( 500 );
     std::chrono::steady_clock::time_point last_update = std::chrono::steady_clock::now();
-
-    for( auto &elem : submaps ) {
-        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    // Only reads the map, the workers never touch anything the ui draws.
+    const auto update_ui = [&]() {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
         if( last_update + update_interval < now ) {
             popup.message( _( "Please wait as the map saves [%d/%d]" ),
-                           num_saved_submaps, num_total_submaps );
+                           num_saved_submaps.load(), num_total_submaps );
             ui_manager::redraw();
             refresh_display();
             inp_mngr.pump_events();
             last_update = now;
         }
-        // Whatever the coordinates of the current submap are,
-        // we're saving a 2x2 quad of submaps at a time.
-        // Submaps are generated in quads, so we know if we have one member of a quad,
-        // we have the rest of it, if that assumption is broken we have REAL problems.
-        const tripoint_abs_omt om_addr = project_to<coords::omt>( elem.first );
-        if( saved_submaps.count( om_addr ) != 0 ) {
-            // Already handled this one.
-            continue;
-        }
-        saved_submaps.insert( om_addr );
+    };
 
-        // A segment is a chunk of 32x32 submap quads.
-        // We're breaking them into subdirectories so there aren't too many files per directory.
-        // Might want to make a set for this one too so it's only checked once per save().
-        const cata_path dirname = find_dirname( om_addr );
-        const cata_path quad_path = find_quad_path( dirname, om_addr );
-
-        bool inside_reality_bubble = here.inbounds( om_addr );
-        // delete_on_save deletes everything, otherwise delete submaps
-        // outside the current map.
-        save_quad( dirname, quad_path, om_addr, submaps_to_delete,
-                   delete_after_save || !inside_reality_bubble );
-        num_saved_submaps += 4;
+    for( size_t i = 0; i < jobs.size(); ++i ) {
+        quad_save_job &job = jobs[i];
+        job.json.reserve( job.submaps.size() );
+        for( const std::pair<tripoint_abs_sm, const submap *> &elem : job.submaps ) {
+            job.json.push_back( quad_file::serialize_json( *elem.second ) );
+        }
+        // Don't create the directory if it would be empty
+        assure_dir_exist( job.dirname );
+        {
+            std::lock_guard<std::mutex> lock( jobs_mutex );
+            num_ready_jobs = i + 1;
+        }
+        jobs_cv.notify_one();
+        update_ui();
     }
+    {
+        std::unique_lock<std::mutex> lock( jobs_mutex );
+        all_ready = true;
+        jobs_cv.notify_all();
+        while( num_written_jobs < jobs.size() ) {
+            written_cv.wait_for( lock, update_interval );
+            lock.unlock();
+            update_ui();
+            lock.lock();
+        }
+    }
+    for( const quad_save_job &job : jobs ) {
+        if( job.error ) {
+            std::rethrow_exception( job.error );
+        }
+    }
+
     for( auto &elem : submaps_to_delete ) {
         remove_submap( elem );
     }
 }
 
-void mapbuffer::save_quad(
-    const cata_path &dirname, const cata_path &filename, const tripoint_abs_omt &om_addr,
-    std::list<tripoint_abs_sm> &submaps_to_delete, bool delete_after_save )
+void mapbuffer::plan_quad_save( const tripoint_abs_omt &om_addr,
+                                std::list<tripoint_abs_sm> &submaps_to_delete,
+                                std::vector<quad_save_job> &jobs, bool delete_after_save )
 {
-    std::vector<point_rel_sm> offsets;
-    std::vector<tripoint_abs_sm> submap_addrs;
-    offsets.reserve( 4 );
-    submap_addrs.reserve( 4 );
-    offsets.push_back( point_rel_sm::zero );
-    offsets.push_back( point_rel_sm::south );
-    offsets.push_back( point_rel_sm::east );
-    offsets.push_back( point_rel_sm::south_east );
+    quad_save_job job;
+    // A segment is a chunk of 32x32 submap quads.
+    // We're breaking them into subdirectories so there aren't too many files per directory.
+    job.dirname = find_dirname( om_addr );
+    job.path = find_quad_path( job.dirname, om_addr );
 
     bool all_uniform = true;
     bool reverted_to_uniform = false;
-    bool const file_exists = std::filesystem::exists( filename.get_unrelative_path() );
-    for( point_rel_sm &offsets_offset : offsets ) {
-        tripoint_abs_sm submap_addr = project_to<coords::sm>( om_addr );
-        submap_addr += offsets_offset.raw(); // TODO: Make += etc. available to relative parameters as well.
-        submap_addrs.push_back( submap_addr );
-        submap *sm = submaps[submap_addr].get();
-        if( sm != nullptr ) {
-            if( !sm->is_uniform() ) {
-                all_uniform = false;
-            } else if( sm->reverted ) {
-                reverted_to_uniform = file_exists;
-            }
+    bool const file_exists = std::filesystem::exists( job.path.get_unrelative_path() );
+    const std::array<std::unique_ptr<submap>, 4> &quad_submaps = quads.at( om_addr ).submaps;
+    const tripoint_abs_sm base = project_to<coords::sm>( om_addr );
+    for( size_t i = 0; i < quad_submaps.size(); ++i ) {
+        const submap *sm = quad_submaps[i].get();
+        if( sm == nullptr ) {
+            continue;
         }
-    }
-
-    if( all_uniform ) {
-        // Nothing to save - this quad will be regenerated faster than it would be re-read
-        if( delete_after_save ) {
-            for( auto &submap_addr : submap_addrs ) {
-                if( submaps.count( submap_addr ) > 0 && submaps[submap_addr] != nullptr ) {
-                    submaps_to_delete.push_back( submap_addr );
-                }
-            }
+        const tripoint_abs_sm submap_addr = base + point( i % 2, i / 2 );
+        if( !sm->is_uniform() ) {
+            all_uniform = false;
+        } else if( sm->reverted ) {
+            reverted_to_uniform = file_exists;
         }
-
-        // deleting the file might fail on some platforms in some edge cases so force serialize this
-        // uniform quad
-        if( !reverted_to_uniform ) {
-            return;
+        job.submaps.emplace_back( submap_addr, sm );
+        if( delete_after_save ) {
+            submaps_to_delete.push_back( submap_addr );
         }
     }
 
-    // Don't create the directory if it would be empty
-    assure_dir_exist( dirname );
-    write_to_file( filename, [&]( std::ostream & fout ) {
-        JsonOut jsout( fout );
-        jsout.start_array();
-        for( auto &submap_addr : submap_addrs ) {
-            if( submaps.count( submap_addr ) == 0 ) {
-                continue;
-            }
-
-            submap *sm = submaps[submap_addr].get();
-
-            if( sm == nullptr ) {
-                continue;
-            }
-
-            jsout.start_object();
-
-            jsout.member( "version", savegame_version );
-            jsout.member( "coordinates" );
-
-            jsout.start_array();
-            jsout.write( submap_addr.x() );
-            jsout.write( submap_addr.y() );
-            jsout.write( submap_addr.z() );
-            jsout.end_array();
-
-            sm->store( jsout );
-
-            jsout.end_object();
-
-            if( delete_after_save ) {
-                submaps_to_delete.push_back( submap_addr );
-            }
-        }
-
-        jsout.end_array();
-    } );
-
-    if( all_uniform && reverted_to_uniform ) {
-        std::filesystem::remove( filename.get_unrelative_path() );
+    if( all_uniform && !reverted_to_uniform ) {
+        // Nothing to save - this quad will be regenerated faster than it would be re-read
+        return;
     }
+    // deleting the file might fail on some platforms in some edge cases so force serialize this
+    // uniform quad
+    job.remove_file = all_uniform;
+    jobs.push_back( std::move( job ) );
 }
 
 // We're reading in way too many entities here to mess around with creating sub-objects and
@@ -329,23 +448,34 @@ submap *mapbuffer::unserialize_submaps( const tripoint_abs_sm &p )
         }
     }
 
-    if( !read_from_file_optional_json( quad_path, [this]( const JsonValue & jsin ) {
-    deserialize( jsin );
-    } ) ) {
+    std::optional<std::string> contents = read_whole_file( quad_path );
+    if( !contents ) {
         // If it doesn't exist, trigger generating it.
         return nullptr;
     }
+    if( quad_file::is_binary( *contents ) ) {
+        quad_file::read( *contents, [this]( const tripoint_abs_sm & loc, std::unique_ptr<submap> &sm ) {
+            if( !add_submap( loc, sm ) ) {
+                debugmsg( "submap %s was already loaded", loc.to_string() );
+            }
+        } );
+    } else {
+        // Saved as json by an earlier version
+        deserialize( json_loader::from_string( *contents ) );
+    }
 
     // fill in uniform submaps that were not serialized. Note that failure as a result of it
     // not being uniform is OK and results in any missing uniform submaps being generated.
     oter_id const oid = overmap_buffer.ter( om_addr );
     generate_uniform_omt( project_to<coords::sm>( om_addr ), oid );
-    if( submaps.count( p ) == 0 ) {
+    std::unique_ptr<submap> *slot = find_slot( p );
+    if( slot == nullptr || *slot == nullptr ) {
         debugmsg( "file %s did not contain the expected submap %s for non-uniform terrain %s",
                   quad_path.generic_u8string(), p.to_string(), oid.id().str() );
+        return nullptr;
     }
 
-    return submaps[ p ].get();
+    return slot->get();
 }
 
 void mapbuffer::deserialize( const JsonArray &ja )
@@ -2,9 +2,12 @@
 #ifndef CATA_SRC_MAPBUFFER_H
 #define CATA_SRC_MAPBUFFER_H
 
+#include <array>
+#include <cstddef>
 #include <list>
-#include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "coordinates.h"
 
@@ -66,17 +69,6 @@ class mapbuffer
         // Cheaper version of the above for when you don't mind some false results
         bool submap_exists_approx( const tripoint_abs_sm &p );
 
-    private:
-        using submap_map_t = std::map<tripoint_abs_sm, std::unique_ptr<submap>>;
-
-    public:
-        inline submap_map_t::iterator begin() {
-            return submaps.begin();
-        }
-        inline submap_map_t::iterator end() {
-            return submaps.end();
-        }
-
     private:
         // There's a very good reason this is private,
         // if not handled carefully, this can erase in-use submaps and crash the game.
@@ -84,11 +76,29 @@ class mapbuffer
         submap *unserialize_submaps( const tripoint_abs_sm &p );
         bool submap_file_exists( const tripoint_abs_sm &p );
         void deserialize( const JsonArray &ja );
-        void save_quad(
-            const cata_path &dirname, const cata_path &filename,
-            const tripoint_abs_omt &om_addr, std::list<tripoint_abs_sm> &submaps_to_delete,
-            bool delete_after_save );
-        submap_map_t submaps; // NOLINT(cata-serialize)
+        struct quad_save_job;
+        /**
+         * Work out what saving the quad at @p om_addr takes: submaps to drop from the buffer
+         * afterwards go to @p submaps_to_delete, and the file to write or remove, if any,
+         * is appended to @p jobs. The submaps themselves are serialized later.
+         */
+        void plan_quad_save( const tripoint_abs_omt &om_addr,
+                             std::list<tripoint_abs_sm> &submaps_to_delete,
+                             std::vector<quad_save_job> &jobs, bool delete_after_save );
+
+        // Submaps are generated, saved and loaded in 2x2 quads, so they're indexed by quad.
+        struct quad {
+            // Indexed by quad_index()
+            std::array<std::unique_ptr<submap>, 4> submaps;
+
+            bool empty() const;
+        };
+        static size_t quad_index( const tripoint_abs_sm &p );
+        // The slot for @p p, nullptr if its quad isn't in the buffer at all.
+        std::unique_ptr<submap> *find_slot( const tripoint_abs_sm &p );
+
+        std::unordered_map<tripoint_abs_omt, quad> quads; // NOLINT(cata-serialize)
+        size_t num_submaps = 0; // NOLINT(cata-serialize)
 };
 
 extern mapbuffer MAPBUFFER;
@@ -2,9 +2,11 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <climits>
 #include <cmath>
 #include <cstdlib>
+#include <filesystem>
 #include <functional>
 #include <list>
 #include <map>
@@ -15,13 +17,13 @@
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
-#include <typeinfo>
 #include <unordered_map>
 
 #include "all_enum_values.h"
 #include "avatar.h"
 #include "calendar.h"
 #include "cata_assert.h"
+#include "cata_scope_helpers.h"
 #include "cata_utility.h"
 #include "catacharset.h"
 #include "character_id.h"
@@ -41,6 +43,7 @@
 #include "enum_conversions.h"
 #include "enums.h"
 #include "field_type.h"
+#include "filesystem.h"
 #include "flat_set.h"
 #include "game.h"
 #include "generic_factory.h"
@@ -76,6 +79,7 @@
 #include "output.h"
 #include "overmap.h"
 #include "overmapbuffer.h"
+#include "path_info.h"
 #include "pocket_type.h"
 #include "point.h"
 #include "regional_settings.h"
@@ -917,6 +921,123 @@ void mapgen_function_builtin::generate( mapgendata &mgd )
     ( *fptr )( mgd );
 }
 
+static bool check_only_changed_mapgens = false;
+
+void set_check_only_changed_mapgens( bool only_changed )
+{
+    check_only_changed_mapgens = only_changed;
+}
+
+/**
+ * Runs the checks of the loaded mapgens, keeping track of the json file each one came from.
+ *
+ * When only changed mapgens are checked, the modification time of every file whose
+ * mapgens passed their checks is remembered in the user cache directory, and the mapgens
+ * of files that haven't been touched since are skipped on the next run. Built-in mapgens
+ * don't come from a file and are always checked.
+ */
+class mapgen_checker
+{
+    public:
+        explicit mapgen_checker( bool only_changed ) : only_changed( only_changed ) {
+            if( only_changed ) {
+                read_from_file_optional_json( cache_path(), [this]( const JsonValue & jv ) {
+                    for( const JsonMember jm : jv.get_object() ) {
+                        clean_files[jm.name()] = jm.get_int64();
+                    }
+                } );
+            }
+        }
+
+        void check( const std::string &source, const std::function<void()> &run_check ) {
+            if( source.empty() ) {
+                run_check();
+                return;
+            }
+            auto it = files.find( source );
+            if( it == files.end() ) {
+                it = files.emplace( source, file_state{ mtime_of( source ) } ).first;
+                const auto clean_it = clean_files.find( source );
+                it->second.skip = only_changed && it->second.mtime &&
+                                  clean_it != clean_files.end() && clean_it->second == *it->second.mtime;
+            }
+            if( it->second.skip ) {
+                skipped++;
+                return;
+            }
+            const int debugmsgs_before = debugmsg_count();
+            run_check();
+            if( debugmsg_count() != debugmsgs_before ) {
+                it->second.clean = false;
+            }
+        }
+
+        /// Remembers the files that passed, full checks leave the cache alone.
+        void finish() {
+            if( !only_changed ) {
+                return;
+            }
+            for( const std::pair<const std::string, file_state> &f : files ) {
+                if( f.second.skip ) {
+                    continue;
+                }
+                if( f.second.clean && f.second.mtime ) {
+                    clean_files[f.first] = *f.second.mtime;
+                } else {
+                    clean_files.erase( f.first );
+                }
+            }
+            assure_dir_exist( PATH_INFO::user_dir_path() / "cache" );
+            write_to_file( cache_path(), [this]( std::ostream & fout ) {
+                JsonOut jsout( fout, true );
+                jsout.write( clean_files );
+            }, _( "mapgen check cache" ) );
+            if( skipped > 0 ) {
+                DebugLog( D_INFO, D_MAIN ) << "Skipped checking " << skipped <<
+                                           " mapgens from unchanged files.";
+            }
+        }
+
+    private:
+        struct file_state {
+            std::optional<int64_t> mtime;
+            bool skip = false;
+            bool clean = true;
+        };
+
+        static cata_path cache_path() {
+            return PATH_INFO::user_dir_path() / "cache" / "mapgen_checks.json";
+        }
+
+        static std::optional<int64_t> mtime_of( const std::string &source ) {
+            std::error_code ec;
+            const std::filesystem::file_time_type mtime =
+                std::filesystem::last_write_time( std::filesystem::u8path( source ), ec );
+            if( ec ) {
+                return std::nullopt;
+            }
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                       mtime.time_since_epoch() ).count();
+        }
+
+        bool only_changed;
+        int skipped = 0;
+        std::map<std::string, int64_t> clean_files;
+        std::map<std::string, file_state> files;
+};
+
+static std::string mapgen_source( const mapgen_function_json_base &mapgen )
+{
+    return mapgen.jsobj.get_source_path().u8string();
+}
+
+static std::string mapgen_source( const mapgen_function &mapgen )
+{
+    const mapgen_function_json_base *json_mapgen =
+        dynamic_cast<const mapgen_function_json_base *>( &mapgen );
+    return json_mapgen ? mapgen_source( *json_mapgen ) : std::string();
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////
 ///// mapgen_function class.
@@ -999,9 +1120,12 @@ class mapgen_basic_container
                 mapgen_function_ptr.obj->finalize_parameters();
             }
         }
-        void check_consistency() const {
+        void check_consistency( mapgen_checker &checker ) const {
             for( const auto &mapgen_function_ptr : weights_ ) {
-                mapgen_function_ptr.obj->check();
+                const mapgen_function &mapgen = *mapgen_function_ptr.obj;
+                checker.check( mapgen_source( mapgen ), [&mapgen]() {
+                    mapgen.check();
+                } );
             }
         }
         void check_consistency_with( const oter_t &ter ) const {
@@ -1064,12 +1188,12 @@ class mapgen_factory
                 omw.second.finalize_parameters();
             }
         }
-        void check_consistency() const {
+        void check_consistency( mapgen_checker &checker ) const {
             // Cache all strings that may get looked up here so we don't have to go through
             // all the sources for them upon each loop.
             const std::set<std::string> usages = get_usages();
             for( const std::pair<const std::string, mapgen_basic_container> &omw : mapgens_ ) {
-                omw.second.check_consistency();
+                omw.second.check_consistency( checker );
                 if( usages.count( omw.first ) == 0 ) {
                     debugmsg( "Mapgen %s is not used by anything!", omw.first );
                 }
@@ -1211,19 +1335,29 @@ void calculate_mapgen_weights()   // TODO: rename as it runs jsonfunction setup
     }
 }
 
+// The checks run one after another on this thread: they look up string_ids, whose cached
+// indices aren't thread-safe, and report through debugmsg.
 void check_mapgen_definitions()
 {
-    oter_mapgen.check_consistency();
+    mapgen_checker checker( check_only_changed_mapgens );
+    oter_mapgen.check_consistency( checker );
     for( const auto &oter_definition : nested_mapgens ) {
         for( const auto &mapgen_function_ptr : oter_definition.second.funcs() ) {
-            mapgen_function_ptr.obj->check();
+            const mapgen_function_json_nested &mapgen = *mapgen_function_ptr.obj;
+            checker.check( mapgen_source( mapgen ), [&mapgen]() {
+                mapgen.check();
+            } );
         }
     }
     for( const auto &oter_definition : update_mapgens ) {
         for( const auto &mapgen_function_ptr : oter_definition.second.funcs() ) {
-            mapgen_function_ptr->check();
+            const update_mapgen_function_json &mapgen = *mapgen_function_ptr;
+            checker.check( mapgen_source( mapgen ), [&mapgen]() {
+                mapgen.check();
+            } );
         }
     }
+    checker.finish();
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -1307,6 +1441,18 @@ load_mapgen_function( const JsonObject &jio, const std::string &id_base,
     return nullptr;
 }
 
+std::shared_ptr<mapgen_function_json_nested> load_nested_mapgen_function( const JsonObject &jo,
+        const std::string &context )
+{
+    return std::make_shared<mapgen_function_json_nested>( jo, context, false );
+}
+
+std::shared_ptr<update_mapgen_function_json> load_update_mapgen_function( const JsonObject &jo,
+        const std::string &context )
+{
+    return std::make_shared<update_mapgen_function_json>( jo, context, false );
+}
+
 static void add_editor_mapgen(const std::string& editor_id_base, std::shared_ptr<mapgen_function_json> f) {
     std::string combined_id = editor_id_base;
     int counter = 0;
@@ -2614,6 +2760,9 @@ class jmapgen_constrained : public jmapgen_piece
         mapgen_phase phase() const override {
             return underlying_piece->phase();
         }
+        bool needs_resolved_terrain() const override {
+            return underlying_piece->needs_resolved_terrain();
+        }
         void check( const std::string &context, const mapgen_parameters &params,
                     const jmapgen_int &x, const jmapgen_int &y, const jmapgen_int &z ) const override {
             underlying_piece->check( context, params, x, y, z );
@@ -2641,6 +2790,15 @@ class jmapgen_constrained : public jmapgen_piece
         virtual const jmapgen_piece* get_constrained_inner() const {
             return underlying_piece.get();
         }
+
+        std::vector<std::pair<std::string, std::string>> get_constraints() const override {
+            std::vector<std::pair<std::string, std::string>> ret;
+            ret.reserve( constraints.size() );
+            for( const mapgen_constraint<Value> &constraint : constraints ) {
+                ret.emplace_back( constraint.parameter_name, constraint.value.str() );
+            }
+            return ret;
+        }
 };
 
 /**
@@ -3109,6 +3267,9 @@ class jmapgen_item_group : public jmapgen_piece
                 faction = jsi.get_string( "faction" );
             }
         }
+        jmapgen_piece_kind kind() const override {
+            return jmapgen_piece_kind::item_group;
+        }
         void check( const std::string &context, const mapgen_parameters &,
                     const jmapgen_int &/*x*/, const jmapgen_int &/*y*/, const jmapgen_int &/*z*/ ) const override {
             if( !group_id.is_valid() ) {
@@ -3444,6 +3605,10 @@ class jmapgen_vehicle : public jmapgen_piece_with_has_vehicle_collision
                 faction = jsi.get_string( "faction" );
             }
         }
+        bool needs_resolved_terrain() const override {
+            // Collisions with local "terrain" can only be determined once it is resolved
+            return true;
+        }
         void apply( const mapgendata &dat, const jmapgen_int &x, const jmapgen_int &y, const jmapgen_int &z,
                     const std::string &/*context*/ ) const override {
             if( !x_in_y( chance, 100 ) ) {
@@ -3621,6 +3786,9 @@ class jmapgen_spawn_item : public jmapgen_piece
             }
             repeat = jmapgen_int( jsi, "repeat", 1, 1 );
         }
+        jmapgen_piece_kind kind() const override {
+            return jmapgen_piece_kind::spawn_item;
+        }
         void apply( const mapgendata &dat, const jmapgen_int &x, const jmapgen_int &y, const jmapgen_int &z,
                     const std::string &/*context*/ ) const override {
             itype_id chosen_id = type.get( dat );
@@ -3713,6 +3881,9 @@ class jmapgen_furniture : public jmapgen_piece_with_has_vehicle_collision
         mapgen_phase phase() const override {
             return mapgen_phase::furniture;
         }
+        jmapgen_piece_kind kind() const override {
+            return jmapgen_piece_kind::furniture;
+        }
         void apply( const mapgendata &dat, const jmapgen_int &x, const jmapgen_int &y, const jmapgen_int &z,
                     const std::string &context ) const override {
             const furn_id &chosen_id = id.get( dat );
@@ -3752,6 +3923,9 @@ class jmapgen_terrain : public jmapgen_piece_with_has_vehicle_collision
         mapgen_phase phase() const override {
             return mapgen_phase::terrain;
         }
+        jmapgen_piece_kind kind() const override {
+            return jmapgen_piece_kind::terrain;
+        }
 
         void apply( const mapgendata &dat, const jmapgen_int &x, const jmapgen_int &y, const jmapgen_int &z,
                     const std::string &context ) const override {
@@ -5001,6 +5175,31 @@ void mapgen_palette::load_place_mapings( const JsonObject &jo, const std::string
 
 std::map<palette_id, mapgen_palette> palettes;
 
+namespace
+{
+struct flattened_palette {
+    // nullptr if the palette can't be flattened on its own
+    shared_ptr_fast<const mapgen_palette> palette;
+    // Every palette merged into it, to spot callers that would make a loop
+    std::set<palette_id> tree;
+};
+
+struct flattened_palette_key {
+    palette_id id;
+    std::vector<std::pair<std::string, palette_id>> bindings;
+
+    bool operator<( const flattened_palette_key &rhs ) const {
+        return std::tie( id, bindings ) < std::tie( rhs.id, rhs.bindings );
+    }
+};
+} // namespace
+
+// Memoized results of mapgen_palette::get_flattened, without and with palette-choice
+// constraints.
+static std::map<palette_id, flattened_palette> flattened_palettes;
+static std::map<flattened_palette_key, shared_ptr_fast<const mapgen_palette>>
+        constrained_palettes;
+
 template<>
 const mapgen_palette &string_id<mapgen_palette>::obj() const
 {
@@ -5104,6 +5303,7 @@ void mapgen_palette::load( const JsonObject &jo, std::string_view src )
     }
 
     palettes[ ret.id ] = ret;
+    clear_flattened();
 }
 
 const mapgen_palette &mapgen_palette::get( const palette_id &id )
@@ -5133,6 +5333,51 @@ void mapgen_palette::check_definitions()
 void mapgen_palette::reset()
 {
     palettes.clear();
+    clear_flattened();
+}
+
+void mapgen_palette::clear_flattened()
+{
+    flattened_palettes.clear();
+    constrained_palettes.clear();
+}
+
+shared_ptr_fast<const mapgen_palette> mapgen_palette::resolve( const palette_id &id,
+        bool flatten )
+{
+    mapgen_palette ret;
+    add_palette_context context( "palette " + id.str(), &ret.parameters );
+    context.flatten = flatten;
+    ret.add( id, context );
+    return make_shared_fast<const mapgen_palette>( std::move( ret ) );
+}
+
+mapgen_palette_override::mapgen_palette_override() = default;
+
+mapgen_palette_override::~mapgen_palette_override()
+{
+    for( std::pair<const palette_id, std::optional<mapgen_palette>> &it : saved ) {
+        if( it.second ) {
+            palettes[it.first] = std::move( *it.second );
+        } else {
+            palettes.erase( it.first );
+        }
+    }
+    mapgen_palette::clear_flattened();
+}
+
+void mapgen_palette_override::load( const JsonObject &jo, std::string_view src )
+{
+    const palette_id id( jo.get_string( "id" ) );
+    if( saved.count( id ) == 0 ) {
+        const auto iter = palettes.find( id );
+        if( iter != palettes.end() ) {
+            saved.emplace( id, iter->second );
+        } else {
+            saved.emplace( id, std::nullopt );
+        }
+    }
+    mapgen_palette::load( jo, src );
 }
 
 void mapgen_palette::add( const mapgen_value<std::string> &rh, const add_palette_context &context )
@@ -5172,7 +5417,123 @@ void mapgen_palette::add( const mapgen_value<std::string> &rh, const add_palette
 
 void mapgen_palette::add( const palette_id &rh, const add_palette_context &context )
 {
-    add( get( rh ), context );
+    const mapgen_palette &source = get( rh );
+    const shared_ptr_fast<const mapgen_palette> flat =
+        context.flatten ? get_flattened( source, context ) : nullptr;
+    if( !flat ) {
+        add( source, context );
+        return;
+    }
+    for( const auto &placing : flat->format_placings ) {
+        std::vector<shared_ptr_fast<const jmapgen_piece>> &these_placings =
+                    format_placings[placing.first];
+        these_placings.insert( these_placings.end(), placing.second.begin(), placing.second.end() );
+    }
+    for( const map_key &placing : flat->keys_with_terrain ) {
+        keys_with_terrain.insert( placing );
+    }
+    std::string actual_context = id.is_empty() ? context.context : "palette " + id.str();
+    parameters.check_and_merge( flat->parameters, actual_context );
+}
+
+bool mapgen_palette::can_flatten( const mapgen_palette &rh, std::vector<palette_id> &stack,
+                                  std::set<palette_id> &tree )
+{
+    stack.push_back( rh.id );
+    tree.insert( rh.id );
+    for( const mapgen_value<std::string> &used : rh.palettes_used ) {
+        const std::vector<std::string> possible_values = used.all_possible_results( rh.parameters );
+        if( possible_values.empty() ||
+            ( possible_values.size() > 1 && !used.get_name_if_parameter() ) ) {
+            // Reported by, or synthesizes a parameter into, whichever mapgen adds it
+            return false;
+        }
+        for( const std::string &value : possible_values ) {
+            const palette_id used_id( value );
+            const auto iter = palettes.find( used_id );
+            if( iter == palettes.end() ||
+                std::find( stack.begin(), stack.end(), used_id ) != stack.end() ||
+                !can_flatten( iter->second, stack, tree ) ) {
+                return false;
+            }
+        }
+    }
+    stack.pop_back();
+    return true;
+}
+
+shared_ptr_fast<const mapgen_palette> mapgen_palette::get_flattened(
+    const mapgen_palette &rh, const add_palette_context &context )
+{
+    if( rh.id.is_empty() ) {
+        return nullptr;
+    }
+
+    auto iter = flattened_palettes.find( rh.id );
+    if( iter == flattened_palettes.end() ) {
+        // Check first, so that palettes that can't be flattened are only merged, and their
+        // problems only reported, once by the regular path
+        flattened_palette flattened;
+        std::vector<palette_id> stack;
+        if( can_flatten( rh, stack, flattened.tree ) ) {
+            mapgen_palette flat;
+            // Whatever is reported while merging is about the palette, not about whichever
+            // mapgen happens to add it first
+            add_palette_context flat_context( "palette " + rh.id.str(), &flat.parameters );
+            flat.add( rh, flat_context );
+            flattened.palette = make_shared_fast<const mapgen_palette>( std::move( flat ) );
+        }
+        iter = flattened_palettes.emplace( rh.id, std::move( flattened ) ).first;
+    }
+    const flattened_palette &unconstrained = iter->second;
+    if( !unconstrained.palette ) {
+        return nullptr;
+    }
+    for( const palette_id &ancestor : context.ancestors ) {
+        if( unconstrained.tree.count( ancestor ) ) {
+            // Let the regular path report the loop
+            return nullptr;
+        }
+    }
+    if( context.constraints.empty() ) {
+        return unconstrained.palette;
+    }
+
+    flattened_palette_key key{ rh.id, {} };
+    for( const mapgen_constraint<palette_id> &constraint : context.constraints ) {
+        key.bindings.emplace_back( constraint.parameter_name, constraint.value );
+    }
+    const auto constrained_iter = constrained_palettes.find( key );
+    if( constrained_iter != constrained_palettes.end() ) {
+        return constrained_iter->second;
+    }
+
+    mapgen_palette flat;
+    flat.keys_with_terrain = unconstrained.palette->keys_with_terrain;
+    flat.parameters = unconstrained.palette->parameters;
+    // Bind every placing to the outer constraints, keeping constraints that
+    // came from further down the ancestor tree in a single wrapper
+    for( const auto &placing : unconstrained.palette->format_placings ) {
+        std::vector<shared_ptr_fast<const jmapgen_piece>> &these_placings =
+                    flat.format_placings[placing.first];
+        these_placings.reserve( placing.second.size() );
+        for( const shared_ptr_fast<const jmapgen_piece> &piece : placing.second ) {
+            std::vector<mapgen_constraint<palette_id>> constraints = context.constraints;
+            shared_ptr_fast<const jmapgen_piece> underlying = piece;
+            if( const jmapgen_constrained<palette_id> *inner =
+                    dynamic_cast<const jmapgen_constrained<palette_id> *>( piece.get() ) ) {
+                constraints.insert( constraints.end(), inner->constraints.begin(),
+                                    inner->constraints.end() );
+                underlying = inner->underlying_piece;
+            }
+            these_placings.push_back( make_shared_fast<jmapgen_constrained<palette_id>>(
+                                          std::move( underlying ), constraints ) );
+        }
+    }
+    shared_ptr_fast<const mapgen_palette> result =
+        make_shared_fast<const mapgen_palette>( std::move( flat ) );
+    constrained_palettes.emplace( std::move( key ), result );
+    return result;
 }
 
 void mapgen_palette::add( const mapgen_palette &rh, const add_palette_context &context )
@@ -5762,6 +6123,31 @@ void jmapgen_objects::finalize()
 {
     std::stable_sort( objects.begin(), objects.end(), compare_phases );
     objects.shrink_to_fit();
+
+    // Split objects into runs of the same phase and piece kind, so apply can hand
+    // each run to a devirtualized kernel.  The order of objects is kept as is, it
+    // decides both the rng sequence and which piece overwrites which.
+    runs.clear();
+    for( size_t i = 0; i < objects.size(); ++i ) {
+        const jmapgen_piece &what = *objects[i].second;
+        const mapgen_phase phase = what.phase();
+        const jmapgen_piece_kind kind = what.kind();
+        const bool needs_resolved_terrain = what.needs_resolved_terrain();
+        if( runs.empty() || runs.back().phase != phase || runs.back().kind != kind ||
+            runs.back().needs_resolved_terrain != needs_resolved_terrain ) {
+            runs.push_back( { phase, kind, needs_resolved_terrain, i, i } );
+        }
+        runs.back().end = i + 1;
+    }
+    runs.shrink_to_fit();
+
+    size_t run = 0;
+    for( size_t phase = 0; phase < phase_runs.size(); ++phase ) {
+        while( run < runs.size() && static_cast<size_t>( runs[run].phase ) < phase ) {
+            ++run;
+        }
+        phase_runs[phase] = run;
+    }
 }
 
 void jmapgen_objects::check( const std::string &context, const mapgen_parameters &parameters ) const
@@ -6207,6 +6593,12 @@ ret_val<void> mapgen_function_json_base::has_vehicle_collision(
     return objects.has_vehicle_collision( dat, offset );
 }
 
+mapgen_phase_timings &get_mapgen_phase_timings()
+{
+    static mapgen_phase_timings timings;
+    return timings;
+}
+
 static ret_val<void> apply_mapgen_in_phases(
     const mapgendata &md, const std::vector<jmapgen_setmap> &setmap_points,
     const jmapgen_objects &objects, const tripoint_rel_ms &offset, const std::string &context,
@@ -6221,11 +6613,20 @@ static ret_val<void> apply_mapgen_in_phases(
     // We must apply all the mapgen in phases, but the mapgen is split between
     // setmap_points and objects.  So we have to make an outer loop over
     // phases, and apply each type restricted to each phase.
+    mapgen_phase_timings &timings = get_mapgen_phase_timings();
+    static int nesting = 0;
+    const bool timed = timings.enabled && nesting == 0;
+    nesting++;
+    on_out_of_scope leave_nesting( []() {
+        nesting--;
+    } );
     auto setmap_point = setmap_points.begin();
     for( mapgen_phase phase : all_enum_values<mapgen_phase>() ) {
         if( std::find( md.skip.begin(), md.skip.end(), phase ) != md.skip.end() ) {
             continue;
         }
+        const std::chrono::steady_clock::time_point phase_start = timed ?
+                std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
         for( ; setmap_point != setmap_points.end(); ++setmap_point ) {
             const jmapgen_setmap &elem = *setmap_point;
             if( elem.phase() != phase ) {
@@ -6239,6 +6640,11 @@ static ret_val<void> apply_mapgen_in_phases(
         }
 
         objects.apply( md, phase, offset, context );
+        if( timed ) {
+            timings.nanoseconds[static_cast<size_t>( phase )] +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - phase_start ).count();
+        }
     }
     cata_assert( setmap_point == setmap_points.end() );
 
@@ -6356,36 +6762,65 @@ void jmapgen_objects::apply( const mapgendata &dat, mapgen_phase phase,
     apply( dat, phase, tripoint_rel_ms::zero, context );
 }
 
+template<typename PieceType>
+static void apply_objects( const jmapgen_objects::jmapgen_obj *first,
+                           const jmapgen_objects::jmapgen_obj *last, const mapgendata &dat,
+                           const tripoint_rel_ms &offset, const std::string &context )
+{
+    for( ; first != last; ++first ) {
+        jmapgen_place where = first->first;
+        where.offset( tripoint_rel_ms( -offset.raw() ) );
+        const PieceType &what = static_cast<const PieceType &>( *first->second );
+
+        // The user will only specify repeat once in JSON, but it may get loaded both
+        // into the what and where in some cases--we just need the greater value of the two.
+        const int repeat = std::max( where.repeat.get(), what.repeat.get() );
+        for( int i = 0; i < repeat; i++ ) {
+            if constexpr( std::is_same_v<PieceType, jmapgen_piece> ) {
+                what.apply( dat, where.x, where.y, where.z, context );
+            } else {
+                // Qualified call, the concrete type is known so skip the virtual dispatch
+                what.PieceType::apply( dat, where.x, where.y, where.z, context );
+            }
+        }
+    }
+}
+
 void jmapgen_objects::apply( const mapgendata &dat, mapgen_phase phase,
                              const tripoint_rel_ms &offset,
                              const std::string &context ) const
 {
     bool terrain_resolved = false;
 
-    auto range_at_phase = std::equal_range( objects.begin(), objects.end(), phase, compare_phases );
-
-    for( auto it = range_at_phase.first; it != range_at_phase.second; ++it ) {
-        const jmapgen_obj &obj = *it;
-        jmapgen_place where = obj.first;
-        where.offset( tripoint_rel_ms( -offset.raw() ) );
-        const jmapgen_piece &what = *obj.second;
+    const size_t phase_index = static_cast<size_t>( phase );
+    for( size_t r = phase_runs[phase_index]; r < phase_runs[phase_index + 1]; ++r ) {
+        const jmapgen_run &run = runs[r];
+        cata_assert( run.phase == phase );
 
-        cata_assert( what.phase() == phase );
-
-        if( !terrain_resolved && typeid( what ) == typeid( jmapgen_vehicle ) ) {
-            // In order to determine collisions between vehicles and local "terrain" the terrain has to be resolved
-            // This code is based on two assumptions:
-            // 1. The terrain part of a definition is always placed first.
-            // 2. Only vehicles require the terrain to be resolved. The general solution is to use a virtual function.
+        if( !terrain_resolved && run.needs_resolved_terrain ) {
+            // This relies on the terrain part of a definition always being placed first.
             resolve_regional_terrain_and_furniture( dat );
             terrain_resolved = true;
         }
 
-        // The user will only specify repeat once in JSON, but it may get loaded both
-        // into the what and where in some cases--we just need the greater value of the two.
-        const int repeat = std::max( where.repeat.get(), what.repeat.get() );
-        for( int i = 0; i < repeat; i++ ) {
-            what.apply( dat, where.x, where.y, where.z, context );
+        const jmapgen_obj *first = objects.data() + run.begin;
+        const jmapgen_obj *last = objects.data() + run.end;
+        switch( run.kind ) {
+            case jmapgen_piece_kind::terrain:
+                apply_objects<jmapgen_terrain>( first, last, dat, offset, context );
+                break;
+            case jmapgen_piece_kind::furniture:
+                apply_objects<jmapgen_furniture>( first, last, dat, offset, context );
+                break;
+            case jmapgen_piece_kind::item_group:
+                apply_objects<jmapgen_item_group>( first, last, dat, offset, context );
+                break;
+            case jmapgen_piece_kind::spawn_item:
+                apply_objects<jmapgen_spawn_item>( first, last, dat, offset, context );
+                break;
+            case jmapgen_piece_kind::generic:
+                apply_objects<jmapgen_piece>( first, last, dat, offset, context );
+                break;
         }
     }
 }
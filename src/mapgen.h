@@ -2,9 +2,12 @@
 #ifndef CATA_SRC_MAPGEN_H
 #define CATA_SRC_MAPGEN_H
 
+#include <array>
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -110,6 +113,16 @@ inline bool operator<( const mapgen_phase l, const mapgen_phase r )
     return static_cast<int>( l ) < static_cast<int>( r );
 }
 
+/**
+ * How long json mapgen spent in each phase while @ref enabled, for benchmarks.  Only the
+ * outermost mapgen is timed, nested mapgens count towards its nested_mapgen phase.
+ */
+struct mapgen_phase_timings {
+    bool enabled = false;
+    std::array<long long, static_cast<size_t>( mapgen_phase::last )> nanoseconds = {};
+};
+mapgen_phase_timings &get_mapgen_phase_timings();
+
 enum jmapgen_setmap_op {
     JMAPGEN_SETMAP_OPTYPE_POINT = 0,
     JMAPGEN_SETMAP_TER,
@@ -178,6 +191,18 @@ struct jmapgen_setmap {
     ret_val<void> has_vehicle_collision( const mapgendata &dat, const tripoint_rel_ms &offset ) const;
 };
 
+/**
+ * Concrete piece types that @ref jmapgen_objects applies through a devirtualized
+ * kernel.  Anything else is applied through the virtual @ref jmapgen_piece::apply.
+ */
+enum class jmapgen_piece_kind {
+    generic,
+    terrain,
+    furniture,
+    item_group,
+    spawn_item,
+};
+
 /**
  * Basic mapgen object. It is supposed to place or do something on a specific square on the map.
  * Inherit from this class and implement the @ref apply function.
@@ -210,6 +235,14 @@ class jmapgen_piece
         virtual mapgen_phase phase() const {
             return mapgen_phase::default_;
         }
+        /** Used to group homogeneous pieces, see @ref jmapgen_objects::finalize */
+        virtual jmapgen_piece_kind kind() const {
+            return jmapgen_piece_kind::generic;
+        }
+        /** Whether regional terrain and furniture must be resolved before this piece is applied */
+        virtual bool needs_resolved_terrain() const {
+            return false;
+        }
         /** Sanity-check this piece */
         virtual void check( const std::string &/*context*/, const mapgen_parameters &,
                             const jmapgen_int &/*x*/, const jmapgen_int &/*y*/, const jmapgen_int &/*z*/ ) const { }
@@ -234,6 +267,10 @@ class jmapgen_piece
         virtual const jmapgen_piece* get_constrained_inner() const {
             return nullptr;
         }
+        /** The parameters this piece is constrained by, as parameter name and required value */
+        virtual std::vector<std::pair<std::string, std::string>> get_constraints() const {
+            return {};
+        }
 };
 
 class jmapgen_piece_with_has_vehicle_collision : public jmapgen_piece
@@ -330,6 +367,16 @@ class mapgen_palette
 
         static void reset();
 
+        /** Drops the memoized results of get_flattened, for when palettes change. */
+        static void clear_flattened();
+
+        /**
+         * Merges the palette @p id with all the palettes it uses, the way a mapgen using it
+         * would.  With @p flatten false, the memoized flattened palettes are bypassed and
+         * every palette is merged on its own, for checking they resolve alike.
+         */
+        static shared_ptr_fast<const mapgen_palette> resolve( const palette_id &id, bool flatten );
+
         const std::vector<mapgen_value<std::string>>& get_ancestors() const {
             return palettes_used;
         }
@@ -353,8 +400,31 @@ class mapgen_palette
             mapgen_parameters *top_level_parameters;
             const mapgen_parameters *current_parameters;
             std::vector<mapgen_constraint<palette_id>> constraints;
+            // Whether palettes may be added through get_flattened
+            bool flatten = true;
         };
 
+        /**
+         * Whether @p rh can be flattened independently of whoever adds it: all the palettes
+         * it uses are known, don't loop back on @p stack, and don't need a palette_choice_
+         * parameter synthesized into the caller.  Collects the ids it uses into @p tree.
+         */
+        static bool can_flatten( const mapgen_palette &rh, std::vector<palette_id> &stack,
+                                 std::set<palette_id> &tree );
+
+        /**
+         * Returns the fully resolved (flattened) form of a named palette, with all of
+         * its ancestors merged in and every placing bound to the constraints of the
+         * context.  Results are memoized per palette id and constraint set, so that
+         * mapgens sharing a palette reuse the same pieces instead of re-merging the
+         * whole ancestor tree.  Returns nullptr if the palette can't be flattened
+         * independently of the caller, or if the caller is already adding one of the
+         * palettes it uses.  What merging reports is reported once, in the palette's own
+         * context.
+         */
+        static shared_ptr_fast<const mapgen_palette> get_flattened(
+            const mapgen_palette &rh, const add_palette_context & );
+
         /**
          * Adds a palette to this one. New values take preference over the old ones.
          *
@@ -368,6 +438,25 @@ class mapgen_palette
         void add( const mapgen_palette &rh, const add_palette_context & );
 };
 
+/**
+ * Loads palettes over the game's ones with the same ids for as long as it lives, and puts
+ * the game's ones back afterwards.  For tools that generate with palettes that aren't part
+ * of the game data.
+ */
+class mapgen_palette_override
+{
+    public:
+        mapgen_palette_override();
+        ~mapgen_palette_override();
+        mapgen_palette_override( const mapgen_palette_override & ) = delete;
+        mapgen_palette_override &operator=( const mapgen_palette_override & ) = delete;
+
+        void load( const JsonObject &jo, std::string_view src );
+
+    private:
+        std::map<palette_id, std::optional<mapgen_palette>> saved;
+};
+
 struct jmapgen_objects {
     public:
 
@@ -416,6 +505,20 @@ struct jmapgen_objects {
          */
         using jmapgen_obj = std::pair<jmapgen_place, shared_ptr_fast<const jmapgen_piece> >;
         std::vector<jmapgen_obj> objects;
+
+        /**
+         * Consecutive range of @ref objects sharing phase and piece kind, built by @ref finalize.
+         */
+        struct jmapgen_run {
+            mapgen_phase phase;
+            jmapgen_piece_kind kind;
+            bool needs_resolved_terrain;
+            size_t begin;
+            size_t end;
+        };
+        std::vector<jmapgen_run> runs;
+        // Index of the first run of each phase in @ref runs, the last entry is runs.size()
+        std::array<size_t, static_cast<size_t>( mapgen_phase::last ) + 1> phase_runs = {};
         tripoint_rel_ms m_offset;
         point_rel_ms mapgensize;
         point_rel_ms total_size;
@@ -575,6 +678,13 @@ class update_mapgen
 std::shared_ptr<mapgen_function> load_mapgen_function( const JsonObject &jio,
         const std::string &id_base, const point_rel_omt &offset, const point_rel_omt &total,
     bool editor_mode );
+/*
+ * Load a nested or update mapgen function from its "object" json without registering it anywhere
+ */
+std::shared_ptr<mapgen_function_json_nested> load_nested_mapgen_function( const JsonObject &jo,
+        const std::string &context );
+std::shared_ptr<update_mapgen_function_json> load_update_mapgen_function( const JsonObject &jo,
+        const std::string &context );
 mapgen_function_json* load_and_add_mapgen_function(
     const JsonObject &jio, const std::string &id_base, const point_rel_omt &offset,
     const point_rel_omt &total, bool editor_mode);
@@ -609,6 +719,11 @@ bool has_update_mapgen_for( const update_mapgen_id & );
 void calculate_mapgen_weights(); // throws
 
 void check_mapgen_definitions();
+/**
+ * When set, @ref check_mapgen_definitions skips the mapgens of json files that haven't been
+ * modified since they last passed their checks.
+ */
+void set_check_only_changed_mapgens( bool only_changed );
 
 /// move to building_generation
 enum room_type {
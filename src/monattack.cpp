@@ -3186,7 +3186,8 @@ bool mattack::upgrade( monster *z )
     const map &here = get_map();
 
     std::vector<monster *> targets;
-    for( monster &zed : g->all_monsters() ) {
+    for( monster *zed_ptr : get_creature_tracker().monsters_around( z->pos_abs(), 10, 10 ) ) {
+        monster &zed = *zed_ptr;
         // Check this first because it is a relatively cheap check
         if( zed.can_upgrade() ) {
             // Then do the more expensive ones
@@ -3982,10 +3983,10 @@ bool mattack::mon_leech_evolution( monster *z )
 {
     const bool is_queen = z->has_flag( mon_flag_QUEEN );
     std::list<monster *> queens;
-    for( monster &candidate : g->all_monsters() ) {
-        if( candidate.in_species( species_LEECH_PLANT ) && candidate.has_flag( mon_flag_QUEEN ) &&
-            rl_dist( z->pos_bub(), candidate.pos_bub() ) < 35 ) {
-            queens.push_back( &candidate );
+    for( monster *candidate : get_creature_tracker().monsters_around( z->pos_abs(), 35, 35 ) ) {
+        if( candidate->in_species( species_LEECH_PLANT ) && candidate->has_flag( mon_flag_QUEEN ) &&
+            rl_dist( z->pos_bub(), candidate->pos_bub() ) < 35 ) {
+            queens.push_back( candidate );
         }
     }
     if( !is_queen ) {
@@ -37,6 +37,7 @@
 #include "field_type.h"
 #include "flat_set.h"
 #include "game.h"
+#include "game_constants.h"
 #include "harvest.h"
 #include "imgui/imgui.h"
 #include "item.h"
@@ -3231,7 +3232,10 @@ void monster::die( map *here, Creature *nkiller )
     if( trigger ) {
         int light = g->light_level( posz() );
         map &here = get_map();
-        for( monster &critter : g->all_monsters() ) {
+        // Nobody further away than that can see it happen
+        for( monster *critter_ptr : get_creature_tracker().monsters_around( pos_abs(), light,
+                fov_3d_z_range ) ) {
+            monster &critter = *critter_ptr;
             // Do we actually care about this faction?
             if( critter.faction->attitude( faction ) != MFA_FRIENDLY ) {
                 continue;
@@ -3929,7 +3933,10 @@ void monster::on_hit( map *here, Creature *source, bodypart_id,
 
     if( trigger ) {
         int light = g->light_level( posz() );
-        for( monster &critter : g->all_monsters() ) {
+        // Nobody further away than that can see it happen
+        for( monster *critter_ptr : get_creature_tracker().monsters_around( pos_abs(), light,
+                fov_3d_z_range ) ) {
+            monster &critter = *critter_ptr;
             // Do we actually care about this faction?
             if( critter.faction->attitude( faction ) != MFA_FRIENDLY ) {
                 continue;
@@ -1713,6 +1713,11 @@ void options_manager::add_options_general()
              to_translation( "If not disabled, unique items and/or monsters can spawn during special events (Christmas, Halloween, etc.)" ),
         { { "off", to_translation( "Disabled" ) }, { "items", to_translation( "Items" ) }, { "monsters", to_translation( "Monsters" ) }, { "both", to_translation( "Both" ) } },
         "off" );
+
+        add( "MAP_MEMORY_RESIDENT_MB", page_id, to_translation( "Map memory kept in RAM" ),
+             to_translation( "Megabytes of memorized map kept in memory.  Beyond that, the areas visited least recently are dropped and read back when needed.  What changed in them is kept in a smaller form until the game is saved." ),
+             16, 4096, 256
+           );
     } );
 
     add_empty_line();
@@ -2902,6 +2907,13 @@ void options_manager::add_options_debug()
          false
 #endif
        );
+
+    add_empty_line();
+
+    add( "SHADOWCASTING_THREADS", "debug", to_translation( "Shadowcasting threads" ),
+         to_translation( "Most threads lighting, vision and sight lines are calculated on.  0 = as many as the processor has, up to 8.  1 = only on the main thread." ),
+         0, 8, 0
+       );
 }
 
 void options_manager::add_options_android()
@@ -12,6 +12,7 @@
 #include <optional>
 #include <ostream>
 #include <set>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -22,6 +23,7 @@
 #include "cached_options.h"
 #include "cata_assert.h"
 #include "cata_path.h"
+#include "cata_scope_helpers.h"
 #include "cata_utility.h"
 #include "cata_views.h"
 #include "catacharset.h"
@@ -71,6 +73,10 @@
 #include "translations.h"
 #include "weighted_list.h"
 
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
 static const mongroup_id GROUP_NEMESIS( "GROUP_NEMESIS" );
 static const mongroup_id GROUP_OCEAN_DEEP( "GROUP_OCEAN_DEEP" );
 static const mongroup_id GROUP_OCEAN_SHORE( "GROUP_OCEAN_SHORE" );
@@ -3655,6 +3661,42 @@ void overmap::generate( const overmap *north, const overmap *east,
             }
         }
     }
+
+    // The noise layers only depend on where this overmap is and on the world seed, so they're
+    // evaluated on worker threads while the stages up to the rivers run, unless the overmap
+    // buffer already did so ahead of time. The stages themselves stay in order on this thread,
+    // they share the terrain and the rng.
+    const unsigned seed = g->get_seed();
+    std::unique_ptr<om_noise::overmap_noise_fields> noise =
+        overmap_buffer.take_pregenerated_noise( loc, seed );
+    std::vector<std::thread> noise_workers;
+    const auto join_noise_workers = [&noise_workers]() {
+        for( std::thread &worker : noise_workers ) {
+            if( worker.joinable() ) {
+                worker.join();
+            }
+        }
+    };
+    on_out_of_scope join_noise_workers_on_exit( join_noise_workers );
+    if( !noise ) {
+        noise = std::make_unique<om_noise::overmap_noise_fields>( global_base_point(), seed );
+        const auto evaluate_noise = [&noise_workers]( om_noise::om_noise_field & field, bool needed ) {
+            if( needed ) {
+                noise_workers.emplace_back( [&field]() {
+                    field.evaluate();
+                } );
+            }
+        };
+        const bool has_oceans = settings->overmap_ocean.ocean_start_north != 0 ||
+                                settings->overmap_ocean.ocean_start_east != 0 ||
+                                settings->overmap_ocean.ocean_start_west != 0 ||
+                                settings->overmap_ocean.ocean_start_south != 0;
+        evaluate_noise( noise->lake, get_option<bool>( "OVERMAP_PLACE_LAKES" ) );
+        evaluate_noise( noise->ocean, get_option<bool>( "OVERMAP_PLACE_OCEANS" ) && has_oceans );
+        evaluate_noise( noise->forest, get_option<bool>( "OVERMAP_PLACE_FORESTS" ) );
+        evaluate_noise( noise->floodplain, get_option<bool>( "OVERMAP_PLACE_SWAMPS" ) );
+    }
+
     calculate_urbanity();
     calculate_forestosity();
     if( get_option<bool>( "OVERMAP_POPULATE_OUTSIDE_CONNECTIONS_FROM_NEIGHBORS" ) ) {
@@ -3663,17 +3705,18 @@ void overmap::generate( const overmap *north, const overmap *east,
     if( get_option<bool>( "OVERMAP_PLACE_RIVERS" ) ) {
         place_rivers( north, east, south, west );
     }
+    join_noise_workers();
     if( get_option<bool>( "OVERMAP_PLACE_LAKES" ) ) {
-        place_lakes();
+        place_lakes( noise->lake );
     }
     if( get_option<bool>( "OVERMAP_PLACE_OCEANS" ) ) {
-        place_oceans();
+        place_oceans( noise->ocean );
     }
     if( get_option<bool>( "OVERMAP_PLACE_FORESTS" ) ) {
-        place_forests();
+        place_forests( noise->forest );
     }
     if( get_option<bool>( "OVERMAP_PLACE_SWAMPS" ) ) {
-        place_swamps();
+        place_swamps( noise->floodplain );
     }
     if( get_option<bool>( "OVERMAP_PLACE_RAVINES" ) ) {
         place_ravines();
@@ -4938,10 +4981,9 @@ void overmap::place_forest_trailheads()
     }
 }
 
-void overmap::place_forests()
+void overmap::place_forests( const om_noise::om_noise_field &noise )
 {
     const oter_id default_oter_id( settings->default_oter[OVERMAP_DEPTH] );
-    const om_noise::om_noise_layer_forest f( global_base_point(), g->get_seed() );
 
     for( int x = 0; x < OMAPX; x++ ) {
         for( int y = 0; y < OMAPY; y++ ) {
@@ -4954,7 +4996,7 @@ void overmap::place_forests()
                 continue;
             }
 
-            const float n = f.noise_at( p.xy() );
+            const float n = noise.noise_at( p.xy() );
 
             // If the noise here meets our threshold, turn it into a forest.
             if( n + forest_size_adjust > settings->overmap_forest.noise_threshold_forest_thick ) {
@@ -4967,9 +5009,8 @@ void overmap::place_forests()
 }
 
 
-void overmap::place_lakes()
+void overmap::place_lakes( const om_noise::om_noise_field &noise )
 {
-    const om_noise::om_noise_layer_lake f( global_base_point(), g->get_seed() );
 
     const auto is_lake = [&]( const point_om_omt & p ) {
         // credit to ehughsbaird for thinking up this inbounds solution to infinite flood fill lag.
@@ -4977,7 +5018,7 @@ void overmap::place_lakes()
         if( !inbounds ) {
             return false;
         }
-        return f.noise_at( p ) > settings->overmap_lake.noise_threshold_lake;
+        return noise.noise_at( p ) > settings->overmap_lake.noise_threshold_lake;
     };
 
     const oter_id lake_surface( "lake_surface" );
@@ -5139,14 +5180,13 @@ float overmap::calculate_ocean_gradient( const point_om_omt &p, const point_abs_
     return std::max( { ocean_adjust_N, ocean_adjust_E, ocean_adjust_W, ocean_adjust_S } );
 }
 
-void overmap::place_oceans()
+void overmap::place_oceans( const om_noise::om_noise_field &noise )
 {
     int northern_ocean = settings->overmap_ocean.ocean_start_north;
     int eastern_ocean = settings->overmap_ocean.ocean_start_east;
     int western_ocean = settings->overmap_ocean.ocean_start_west;
     int southern_ocean = settings->overmap_ocean.ocean_start_south;
 
-    const om_noise::om_noise_layer_ocean f( global_base_point(), g->get_seed() );
     const point_abs_om this_om = pos();
 
     const auto is_ocean = [&]( const point_om_omt & p ) {
@@ -5164,7 +5204,7 @@ void overmap::place_oceans()
             // It's too soon!  Too soon for an ocean!!  ABORT!!!
             return false;
         }
-        return f.noise_at( p ) + ocean_adjust > settings->overmap_ocean.noise_threshold_ocean;
+        return noise.noise_at( p ) + ocean_adjust > settings->overmap_ocean.noise_threshold_ocean;
     };
 
     const oter_id ocean_surface( "ocean_surface" );
@@ -5436,7 +5476,7 @@ void overmap::place_rivers( const overmap *north, const overmap *east, const ove
     }
 }
 
-void overmap::place_swamps()
+void overmap::place_swamps( const om_noise::om_noise_field &noise )
 {
     // Buffer our river terrains by a variable radius and increment a counter for the location each
     // time it's included in a buffer. It's a floodplain that we'll then intersect later with some
@@ -5464,7 +5504,6 @@ void overmap::place_swamps()
     }
 
     // Get a layer of noise to use in conjunction with our river buffered floodplain.
-    const om_noise::om_noise_layer_floodplain f( global_base_point(), g->get_seed() );
 
     for( int x = 0; x < OMAPX; x++ ) {
         for( int y = 0; y < OMAPY; y++ ) {
@@ -5477,12 +5516,12 @@ void overmap::place_swamps()
 
             // If this was a part of our buffered floodplain, and the noise here meets the threshold, and the one_in rng
             // triggers, then we should flood this location and make it a swamp.
-            const bool should_flood = ( floodplain[x][y] > 0 && !one_in( floodplain[x][y] ) && f.noise_at( { x, y } )
+            const bool should_flood = ( floodplain[x][y] > 0 && !one_in( floodplain[x][y] ) && noise.noise_at( { x, y } )
                                         > settings->overmap_forest.noise_threshold_swamp_adjacent_water );
 
             // If this location meets our isolated swamp threshold, regardless of floodplain values, we'll make it
             // into a swamp.
-            const bool should_isolated_swamp = f.noise_at( pos.xy() ) >
+            const bool should_isolated_swamp = noise.noise_at( pos.xy() ) >
                                                settings->overmap_forest.noise_threshold_swamp_isolated;
             if( should_flood || should_isolated_swamp )  {
                 ter_set( pos, oter_forest_water );
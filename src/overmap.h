@@ -51,6 +51,12 @@ class overmap_connection;
 struct regional_settings;
 template <typename T> struct enum_traits;
 
+namespace om_noise
+{
+class om_noise_field;
+struct overmap_noise_fields;
+} // namespace om_noise
+
 namespace pf
 {
 template<typename Point>
@@ -470,12 +476,12 @@ class overmap
         float calculate_ocean_gradient( const point_om_omt &p, point_abs_om this_omt );
         // Overall terrain
         void place_river( const point_om_omt &pa, const point_om_omt &pb );
-        void place_forests();
-        void place_lakes();
-        void place_oceans();
+        void place_forests( const om_noise::om_noise_field &noise );
+        void place_lakes( const om_noise::om_noise_field &noise );
+        void place_oceans( const om_noise::om_noise_field &noise );
         void place_rivers( const overmap *north, const overmap *east, const overmap *south,
                            const overmap *west );
-        void place_swamps();
+        void place_swamps( const om_noise::om_noise_field &noise );
         void place_forest_trails();
         void place_forest_trailheads();
 
@@ -1,5 +1,6 @@
 #include <cmath>
 #include <algorithm>
+#include <utility>
 
 #include "overmap_noise.h"
 #include "simplexnoise.h"
@@ -45,4 +46,41 @@ float om_noise_layer_ocean::noise_at( const point_om_omt &local_omt_pos ) const
     return r;
 }
 
+static constexpr int field_width = OMAPX + 2 * om_noise_field::margin;
+static constexpr int field_height = OMAPY + 2 * om_noise_field::margin;
+
+om_noise_field::om_noise_field( std::unique_ptr<om_noise_layer> layer ) : layer( std::move( layer ) )
+{
+}
+
+void om_noise_field::evaluate()
+{
+    std::vector<float> result( field_width * field_height );
+    for( int y = 0; y < field_height; y++ ) {
+        for( int x = 0; x < field_width; x++ ) {
+            result[y * field_width + x] = layer->noise_at( point_om_omt( x - margin, y - margin ) );
+        }
+    }
+    values = std::move( result );
+}
+
+float om_noise_field::noise_at( const point_om_omt &omt_local ) const
+{
+    const int x = omt_local.x() + margin;
+    const int y = omt_local.y() + margin;
+    if( values.empty() || x < 0 || y < 0 || x >= field_width || y >= field_height ) {
+        return layer->noise_at( omt_local );
+    }
+    return values[y * field_width + x];
+}
+
+overmap_noise_fields::overmap_noise_fields( const point_abs_omt &global_base_point,
+        unsigned seed )
+    : lake( std::make_unique<om_noise_layer_lake>( global_base_point, seed ) ),
+      ocean( std::make_unique<om_noise_layer_ocean>( global_base_point, seed ) ),
+      forest( std::make_unique<om_noise_layer_forest>( global_base_point, seed ) ),
+      floodplain( std::make_unique<om_noise_layer_floodplain>( global_base_point, seed ) )
+{
+}
+
 } // namespace om_noise
@@ -2,6 +2,9 @@
 #ifndef CATA_SRC_OVERMAP_NOISE_H
 #define CATA_SRC_OVERMAP_NOISE_H
 
+#include <memory>
+#include <vector>
+
 #include "coordinates.h"
 #include "game_constants.h"
 #include "point.h"
@@ -89,6 +92,40 @@ class om_noise_layer_ocean : public om_noise_layer
         float noise_at( const point_om_omt &local_omt_pos ) const override;
 };
 
+/**
+ * A noise layer evaluated ahead of time over a whole overmap and a margin around it.
+ * noise_at() returns exactly what the layer does, points outside of the field are
+ * computed on demand. Evaluating only reads the layer, so it can happen on another thread,
+ * as long as nothing reads the field meanwhile.
+ */
+class om_noise_field
+{
+    public:
+        // Lakes and oceans are flood filled a few overmap terrains past the overmap edges.
+        static constexpr int margin = 5;
+
+        explicit om_noise_field( std::unique_ptr<om_noise_layer> layer );
+
+        void evaluate();
+
+        float noise_at( const point_om_omt &omt_local ) const;
+
+    private:
+        std::unique_ptr<om_noise_layer> layer;
+        // Empty until evaluate() is called.
+        std::vector<float> values;
+};
+
+/** The noise fields generating one overmap reads, see overmap::generate(). */
+struct overmap_noise_fields {
+    overmap_noise_fields( const point_abs_omt &global_base_point, unsigned seed );
+
+    om_noise_field lake;
+    om_noise_field ocean;
+    om_noise_field forest;
+    om_noise_field floodplain;
+};
+
 } // namespace om_noise
 
 #endif // CATA_SRC_OVERMAP_NOISE_H
@@ -1,6 +1,7 @@
 #include "overmapbuffer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdlib>
 #include <iterator>
@@ -8,6 +9,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <thread>
 #include <tuple>
 
 #include "basecamp.h"
@@ -31,8 +33,10 @@
 #include "monster.h"
 #include "npc.h"
 #include "omdata.h"
+#include "options.h"
 #include "overmap.h"
 #include "overmap_connection.h"
+#include "overmap_noise.h"
 #include "overmap_types.h"
 #include "path_info.h"
 #include "point.h"
@@ -42,6 +46,10 @@
 #include "translations.h"
 #include "vehicle.h"
 
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
 static const oter_type_str_id oter_type_bridgehead_ground( "bridgehead_ground" );
 static const oter_type_str_id oter_type_bridgehead_ramp( "bridgehead_ramp" );
 
@@ -53,11 +61,26 @@ static int omt_to_sm_copy( int a )
 
 overmapbuffer overmap_buffer;
 
+// How close to the edge of its overmap the player has to get before the next one is pregenerated
+static constexpr int pregenerate_distance = OMAPX / 4;
+
+struct pregenerated_noise {
+    unsigned seed = 0;
+    std::unique_ptr<om_noise::overmap_noise_fields> fields;
+    std::thread worker;
+    std::atomic<bool> finished = false;
+};
+
 overmapbuffer::overmapbuffer()
     : last_requested_overmap( nullptr )
 {
 }
 
+overmapbuffer::~overmapbuffer()
+{
+    drop_pregenerated();
+}
+
 const city_reference city_reference::invalid{ nullptr, tripoint_abs_sm(), -1 };
 
 int city_reference::get_distance_from_bounds() const
@@ -119,6 +142,109 @@ void overmapbuffer::create_custom_overmap( const point_abs_om &p, overmap_specia
     new_om.populate( specials );
 }
 
+void overmapbuffer::pregenerate_ahead( const tripoint_abs_omt &pos, const point_rel_sm &heading )
+{
+    point_abs_om om_pos;
+    point_om_omt local;
+    std::tie( om_pos, local ) = project_remain<coords::om>( pos.xy() );
+    // Forget about what we pregenerated for overmaps the player has turned away from
+    for( auto it = pregenerated.begin(); it != pregenerated.end(); ) {
+        if( square_dist( it->first, om_pos ) > 1 && it->second->finished ) {
+            it->second->worker.join();
+            it = pregenerated.erase( it );
+        } else {
+            ++it;
+        }
+    }
+
+    const auto towards_edge = []( int dir, int along, int size ) {
+        if( dir > 0 && along >= size - pregenerate_distance ) {
+            return 1;
+        }
+        if( dir < 0 && along < pregenerate_distance ) {
+            return -1;
+        }
+        return 0;
+    };
+    const point edge( towards_edge( heading.x(), local.x(), OMAPX ),
+                      towards_edge( heading.y(), local.y(), OMAPY ) );
+    if( edge.x != 0 ) {
+        pregenerate( om_pos + point( edge.x, 0 ) );
+    }
+    if( edge.y != 0 ) {
+        pregenerate( om_pos + point( 0, edge.y ) );
+    }
+    if( edge.x != 0 && edge.y != 0 ) {
+        pregenerate( om_pos + edge );
+    }
+}
+
+void overmapbuffer::pregenerate( const point_abs_om &p )
+{
+    if( overmaps.count( p ) > 0 || pregenerated.count( p ) > 0 ||
+        file_exist( terrain_filename( p ) ) ) {
+        return;
+    }
+    std::unique_ptr<pregenerated_noise> &pregen = pregenerated[p];
+    pregen = std::make_unique<pregenerated_noise>();
+    pregen->seed = g->get_seed();
+    pregen->fields = std::make_unique<om_noise::overmap_noise_fields>( project_to<coords::omt>( p ),
+                     pregen->seed );
+    // Whether the region has oceans isn't known before the overmap exists, the ocean noise is
+    // evaluated anyway if they're enabled at all.
+    const bool lakes = get_option<bool>( "OVERMAP_PLACE_LAKES" );
+    const bool oceans = get_option<bool>( "OVERMAP_PLACE_OCEANS" );
+    const bool forests = get_option<bool>( "OVERMAP_PLACE_FORESTS" );
+    const bool swamps = get_option<bool>( "OVERMAP_PLACE_SWAMPS" );
+    om_noise::overmap_noise_fields &fields = *pregen->fields;
+    std::atomic<bool> &finished = pregen->finished;
+    pregen->worker = std::thread( [&fields, &finished, lakes, oceans, forests, swamps]() {
+        if( lakes ) {
+            fields.lake.evaluate();
+        }
+        if( oceans ) {
+            fields.ocean.evaluate();
+        }
+        if( forests ) {
+            fields.forest.evaluate();
+        }
+        if( swamps ) {
+            fields.floodplain.evaluate();
+        }
+        finished = true;
+    } );
+}
+
+std::unique_ptr<om_noise::overmap_noise_fields> overmapbuffer::take_pregenerated_noise(
+    const point_abs_om &p, unsigned seed )
+{
+    const auto it = pregenerated.find( p );
+    if( it == pregenerated.end() ) {
+        return nullptr;
+    }
+    std::unique_ptr<pregenerated_noise> pregen = std::move( it->second );
+    pregenerated.erase( it );
+    pregen->worker.join();
+    if( pregen->seed != seed ) {
+        return nullptr;
+    }
+    return std::move( pregen->fields );
+}
+
+bool overmapbuffer::has_pregenerated_noise( const point_abs_om &p, unsigned seed ) const
+{
+    const auto it = pregenerated.find( p );
+    return it != pregenerated.end() && it->second->seed == seed;
+}
+
+void overmapbuffer::drop_pregenerated()
+{
+    for( std::pair<const point_abs_om, std::unique_ptr<pregenerated_noise>> &pregen : pregenerated ) {
+        pregen.second->worker.join();
+    }
+    pregenerated.clear();
+}
+
 void overmapbuffer::fix_mongroups( overmap &new_overmap )
 {
     for( auto it = new_overmap.zg.begin(); it != new_overmap.zg.end(); ) {
@@ -244,6 +370,7 @@ void overmapbuffer::reset()
 
 void overmapbuffer::clear()
 {
+    drop_pregenerated();
     overmaps.clear();
     known_non_existing.clear();
     placed_unique_specials.clear();
@@ -43,6 +43,7 @@ enum class type : int;
 }  // namespace om_direction
 struct mapgen_arguments;
 struct mongroup;
+struct pregenerated_noise;
 struct regional_settings;
 
 struct overmap_path_params {
@@ -152,6 +153,7 @@ class overmapbuffer
 {
     public:
         overmapbuffer();
+        ~overmapbuffer();
 
         bool externally_set_args = false;
 
@@ -173,6 +175,26 @@ class overmapbuffer
         void clear();
         void create_custom_overmap( const point_abs_om &, overmap_special_batch &specials );
 
+        /**
+         * Predict which overmaps the player at @p pos moving in @p heading is about to need,
+         * and start evaluating the noise they get generated from on a background thread.
+         */
+        void pregenerate_ahead( const tripoint_abs_omt &pos, const point_rel_sm &heading );
+        /**
+         * Start evaluating the noise for the overmap at @p p on a background thread, unless
+         * that overmap already exists or is being pregenerated.
+         */
+        void pregenerate( const point_abs_om &p );
+        /**
+         * Hand over the noise pregenerated for the overmap at @p p, waiting for the background
+         * thread if it hasn't finished yet. Returns null if nothing was pregenerated for it with
+         * this world @p seed.
+         */
+        std::unique_ptr<om_noise::overmap_noise_fields> take_pregenerated_noise(
+            const point_abs_om &p, unsigned seed );
+        /** Whether take_pregenerated_noise would hand over noise for @p p and @p seed. */
+        bool has_pregenerated_noise( const point_abs_om &p, unsigned seed ) const;
+
         /**
          * Returns the overmap terrain at the given OMT coordinates.
          * Creates a new overmap if necessary.
@@ -583,6 +605,9 @@ class overmapbuffer
         std::unordered_map<overmap_special_id, int> unique_special_count;
         // Global count of number of overmaps generated for this world.
         int overmap_count = 0;
+        // Noise being evaluated ahead of time for overmaps that don't exist yet.
+        std::map<point_abs_om, std::unique_ptr<pregenerated_noise>> pregenerated;
+        void drop_pregenerated();
 
         /**
          * Get a list of notes in the (loaded) overmaps.
@@ -2,12 +2,12 @@
 
 #include <algorithm>
 #include <array>
-#include <bitset>
+#include <climits>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <memory>
 #include <optional>
-#include <queue>
 #include <utility>
 #include <vector>
 
@@ -18,6 +18,7 @@
 #include "game.h"
 #include "line.h"
 #include "map.h"
+#include "map_iterator.h"
 #include "map_scale_constants.h"
 #include "mapdata.h"
 #include "maptile_fwd.h"
@@ -38,24 +39,25 @@ static constexpr int flat_index( const point_bub_ms &p )
 
 // Flattened 2D array representing a single z-level worth of pathfinding data
 struct path_data_layer {
-    // Closed/open is accessed way more often than all other values here
-    std::bitset< MAPSIZE_X *MAPSIZE_Y > closed;
-    std::bitset< MAPSIZE_X *MAPSIZE_Y > open;
+    // Closed/open is accessed way more often than all other values here.
+    // A tile is open or closed if it was opened or closed during the current search, so starting
+    // a new one doesn't have to clear anything.
+    std::array< uint32_t, MAPSIZE_X *MAPSIZE_Y > opened_in = {};
+    std::array< uint32_t, MAPSIZE_X *MAPSIZE_Y > closed_in = {};
     std::array< int, MAPSIZE_X *MAPSIZE_Y > score;
     std::array< int, MAPSIZE_X *MAPSIZE_Y > gscore;
     std::array< tripoint_bub_ms, MAPSIZE_X *MAPSIZE_Y > parent;
-
-    void reset() {
-        closed.reset();
-        open.reset();
-    }
 };
 
+// Everything a search needs, kept around so searching doesn't allocate.
 struct pathfinder {
-    using queue_type =
-        std::priority_queue< std::pair<int, tripoint_bub_ms>, std::vector< std::pair<int, tripoint_bub_ms> >, pair_greater_cmp_first >;
-    queue_type open;
+    using queue_entry = std::pair<int, tripoint_bub_ms>;
+    // Binary heap of open points, lowest score on top, like a std::priority_queue would do it.
+    // Its storage is reused from one search to the next.
+    std::vector< queue_entry > open;
     std::array< std::unique_ptr< path_data_layer >, OVERMAP_LAYERS > path_data;
+    // The current search, 0 means none. Tiles stamped with another one are neither open nor closed.
+    uint32_t search = 0;
 
     path_data_layer &get_layer( const int z ) {
         std::unique_ptr< path_data_layer > &ptr = path_data[z + OVERMAP_DEPTH];
@@ -66,14 +68,18 @@ struct pathfinder {
         return *ptr;
     }
 
-    void reset( int minz, int maxz ) {
-        for( int i = minz; i <= maxz; ++i ) {
-            std::unique_ptr< path_data_layer > &ptr = path_data[i + OVERMAP_DEPTH];
-            if( ptr != nullptr ) {
-                path_data[i + OVERMAP_DEPTH]->reset();
+    void reset() {
+        if( ++search == 0 ) {
+            // Stamps from before the wrap around would look current again
+            for( std::unique_ptr< path_data_layer > &layer : path_data ) {
+                if( layer != nullptr ) {
+                    layer->opened_in.fill( 0 );
+                    layer->closed_in.fill( 0 );
+                }
             }
+            search = 1;
         }
-        open = queue_type();
+        open.clear();
     }
 
     bool empty() const {
@@ -81,43 +87,42 @@ struct pathfinder {
     }
 
     tripoint_bub_ms get_next() {
-        const auto pt = open.top();
-        open.pop();
-        return pt.second;
+        std::pop_heap( open.begin(), open.end(), pair_greater_cmp_first() );
+        const tripoint_bub_ms pt = open.back().second;
+        open.pop_back();
+        return pt;
+    }
+
+    bool is_closed( const path_data_layer &layer, const int index ) const {
+        return layer.closed_in[index] == search;
+    }
+
+    void close( path_data_layer &layer, const int index ) const {
+        layer.closed_in[index] = search;
     }
 
     void add_point( const int gscore, const int score, const tripoint_bub_ms &from,
                     const tripoint_bub_ms &to ) {
         path_data_layer &layer = get_layer( to.z() );
         const int index = flat_index( to.xy() );
-        if( layer.closed[index] ) {
+        if( is_closed( layer, index ) ) {
             return;
         }
-        if( layer.open[index] && gscore >= layer.gscore[index] ) {
+        if( layer.opened_in[index] == search && gscore >= layer.gscore[index] ) {
             return;
         }
 
-        layer.open[index] = true;
+        layer.opened_in[index] = search;
         layer.gscore[index] = gscore;
         layer.parent[index] = from;
         layer.score [index] = score;
-        open.emplace( score, to );
-    }
-
-    void close_point( const tripoint_bub_ms &p ) {
-        path_data_layer &layer = get_layer( p.z() );
-        const int index = flat_index( p.xy() );
-        layer.closed[index] = true;
-    }
-
-    void unclose_point( const tripoint_bub_ms &p ) {
-        path_data_layer &layer = get_layer( p.z() );
-        const int index = flat_index( p.xy() );
-        layer.closed[index] = false;
+        open.emplace_back( score, to );
+        std::push_heap( open.begin(), open.end(), pair_greater_cmp_first() );
     }
 };
 
-static pathfinder pf;
+// Each thread searches with a pathfinder of its own.
+static thread_local pathfinder pf;
 
 // Modifies `t` to point to a tile with `flag` in a 1-submap radius of `t`'s original value,
 // searching nearest points first (starting with `t` itself).
@@ -380,6 +385,31 @@ int map::extra_cost( const tripoint_bub_ms &cur, const tripoint_bub_ms &p,
     return pass_cost + avoid_cost;
 }
 
+std::vector<tripoint_bub_ms> map::unobstructed_straight_route( const tripoint_bub_ms &f,
+        const tripoint_bub_ms &t, const std::function<bool( const tripoint_bub_ms & )> &avoid ) const
+{
+    std::vector<tripoint_bub_ms> line_path = straight_route( f, t );
+    if( line_path.empty() ) {
+        return line_path;
+    }
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( f.z() );
+    auto should_avoid = [&avoid, &pf_cache]( const tripoint_bub_ms & p ) {
+        PathfindingFlags flags_copy = PathfindingFlags( pf_cache.special[p.xy()] );
+        flags_copy.set_clear( PathfindingFlag::Ground );
+        if( flags_copy.is_any_set() ) {
+            // If the straight line goes through any tile with any sort of special, then we
+            // don't use the straight-line optimization. Instead, we fall back to regular
+            // pathfinding. The costs might make the pathfinder pick a different path.
+            return true;
+        }
+        return avoid( p );
+    };
+    if( std::any_of( line_path.begin(), line_path.end(), should_avoid ) ) {
+        line_path.clear();
+    }
+    return line_path;
+}
+
 std::vector<tripoint_bub_ms> map::route( const Creature &who,
         const pathfinding_target &target ) const
 {
@@ -410,23 +440,9 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
     // First, check for a simple straight line on flat ground
     // Except when the line contains a pre-closed tile - we need to do regular pathing then
     if( f.z() == t.z() ) {
-        auto line_path = straight_route( f, t );
+        std::vector<tripoint_bub_ms> line_path = unobstructed_straight_route( f, t, avoid );
         if( !line_path.empty() ) {
-            const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( f.z() );
-            auto should_avoid = [&avoid, &pf_cache]( const tripoint_bub_ms & p ) {
-                PathfindingFlags flags_copy = PathfindingFlags( pf_cache.special[p.xy()] );
-                flags_copy.set_clear( PathfindingFlag::Ground );
-                if( flags_copy.is_any_set() ) {
-                    // If the straight line goes through any tile with any sort of special, then we
-                    // don't use the straight-line optimization. Instead, we fall back to regular
-                    // pathfinding. The costs might make the pathfinder pick a different path.
-                    return true;
-                }
-                return avoid( p );
-            };
-            if( std::none_of( line_path.begin(), line_path.end(), should_avoid ) ) {
-                return line_path;
-            }
+            return line_path;
         }
     }
 
@@ -445,7 +461,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
     clip_to_bounds( min.x(), min.y(), min.z() );
     clip_to_bounds( max.x(), max.y(), max.z() );
 
-    pf.reset( min.z(), max.z() );
+    pf.reset();
 
     pf.add_point( 0, 0, f, f );
 
@@ -457,7 +473,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
 
         const int parent_index = flat_index( cur.xy() );
         path_data_layer &layer = pf.get_layer( cur.z() );
-        if( layer.closed[parent_index] ) {
+        if( pf.is_closed( layer, parent_index ) ) {
             continue;
         }
 
@@ -472,7 +488,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
             break;
         }
 
-        layer.closed[parent_index] = true;
+        pf.close( layer, parent_index );
 
         const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( cur.z() );
         const PathfindingFlags cur_special = pf_cache.special[cur.x()][cur.y()];
@@ -492,11 +508,11 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
             }
 
             if( !target.contains( p ) && avoid( p ) ) {
-                layer.closed[index] = true;
+                pf.close( layer, index );
                 continue;
             }
 
-            if( layer.closed[index] ) {
+            if( pf.is_closed( layer, index ) ) {
                 continue;
             }
 
@@ -507,7 +523,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
             const int cost = extra_cost( cur, p, settings, p_special );
             if( cost < 0 ) {
                 if( cost == PF_IMPASSABLE ) {
-                    layer.closed[index] = true;
+                    pf.close( layer, index );
                 }
                 continue;
             }
@@ -535,7 +551,7 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
                         }
 
                         // Close p, because we won't be walking on it
-                        layer.closed[index] = true;
+                        pf.close( layer, index );
                         continue;
                     }
                 }
@@ -662,6 +678,217 @@ std::vector<tripoint_bub_ms> map::route( const tripoint_bub_ms &f,
     return ret;
 }
 
+static bool same_settings( const pathfinding_settings &a, const pathfinding_settings &b )
+{
+    return a.bash_strength == b.bash_strength && a.max_dist == b.max_dist &&
+           a.max_length == b.max_length && a.climb_cost == b.climb_cost &&
+           a.allow_open_doors == b.allow_open_doors && a.allow_unlock_doors == b.allow_unlock_doors &&
+           a.avoid_traps == b.avoid_traps && a.allow_climb_stairs == b.allow_climb_stairs &&
+           a.avoid_rough_terrain == b.avoid_rough_terrain && a.avoid_sharp == b.avoid_sharp &&
+           a.avoid_dangerous_fields == b.avoid_dangerous_fields && a.size == b.size;
+}
+
+// Tiles map::route() never steps on when avoiding traps: it climbs down from next to them instead.
+static bool is_trap_ledge( const map &m, const tripoint_bub_ms &p,
+                           const pathfinding_settings &settings, PathfindingFlags p_special )
+{
+    if( !settings.avoid_traps || !( p_special & PathfindingFlag::DangerousTrap ) ) {
+        return false;
+    }
+    const const_maptile &tile = m.maptile_at( p );
+    const ter_t &terrain = tile.get_ter_t();
+    const trap &ter_trp = terrain.trap.obj();
+    const trap &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
+    return !trp.is_benign() && terrain.has_flag( ter_furn_flag::TFLAG_NO_FLOOR );
+}
+
+// 7 3 5
+// 1 . 2
+// 6 4 8
+static constexpr std::array<point_rel_ms, 8> flow_field_offsets{ {
+        { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 }, { 1, 1 }
+    }
+};
+
+const path_flow_field *map::find_path_flow_field( const pathfinding_target &target,
+        const pathfinding_settings &settings ) const
+{
+    const auto found = std::find_if( path_flow_fields.begin(), path_flow_fields.end(),
+    [&]( const std::unique_ptr<path_flow_field> &field ) {
+        return field->center == target.center && field->r == target.r &&
+               same_settings( field->settings, settings );
+    } );
+    return found == path_flow_fields.end() ? nullptr : found->get();
+}
+
+const path_flow_field *map::get_path_flow_field( const pathfinding_target &target,
+        const pathfinding_settings &settings ) const
+{
+    const int z = target.center.z();
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( z );
+    auto found = std::find_if( path_flow_fields.begin(), path_flow_fields.end(),
+    [&]( const std::unique_ptr<path_flow_field> &field ) {
+        return field->center == target.center && field->r == target.r &&
+               same_settings( field->settings, settings );
+    } );
+    // Keep the least recently used one last, to be replaced once there are enough
+    static constexpr size_t max_flow_fields = 8;
+    if( found == path_flow_fields.end() ) {
+        if( path_flow_fields.size() < max_flow_fields ) {
+            path_flow_fields.push_back( std::make_unique<path_flow_field>() );
+        }
+        found = path_flow_fields.end() - 1;
+        path_flow_field &field = **found;
+        field.center = target.center;
+        field.r = target.r;
+        field.settings = settings;
+        field.requests = 0;
+        field.computed = false;
+        field.builds = 0;
+    }
+    std::rotate( path_flow_fields.begin(), found, found + 1 );
+    path_flow_field &field = *path_flow_fields.front();
+    if( field.turn != calendar::turn || field.generation != pf_cache.generation ) {
+        field.turn = calendar::turn;
+        field.generation = pf_cache.generation;
+        field.requests = 0;
+        field.computed = false;
+    }
+    // Working it out costs several searches, only worth it for a crowd
+    static constexpr int min_requests = 4;
+    if( ++field.requests < min_requests ) {
+        return nullptr;
+    }
+    if( field.computed ) {
+        return &field;
+    }
+    field.computed = true;
+    ++field.builds;
+    field.leaves_level = false;
+
+    // Dijkstra outwards from the target, costing each step the way route() would in the other
+    // direction.
+    cata::mdarray<int, point_bub_ms> &cost = field.cost;
+    cost.fill( INT_MAX );
+    std::vector<std::pair<int, point_bub_ms>> open;
+    const int size = SEEX * my_MAPSIZE;
+    for( const tripoint_bub_ms &p : points_in_radius( target.center, target.r ) ) {
+        if( inbounds( p ) && target.contains( p ) ) {
+            cost[p.x()][p.y()] = 0;
+            open.emplace_back( 0, p.xy() );
+        }
+    }
+    std::make_heap( open.begin(), open.end(), pair_greater_cmp_first() );
+    while( !open.empty() ) {
+        std::pop_heap( open.begin(), open.end(), pair_greater_cmp_first() );
+        const auto [p_cost, p] = open.back();
+        open.pop_back();
+        if( p_cost > cost[p.x()][p.y()] || p_cost > settings.max_length ) {
+            continue;
+        }
+        const tripoint_bub_ms p3( p, z );
+        const PathfindingFlags p_special = pf_cache.special[p.x()][p.y()];
+        if( is_trap_ledge( *this, p3, settings, p_special ) ) {
+            field.leaves_level = true;
+            continue;
+        }
+        for( const point_rel_ms &offset : flow_field_offsets ) {
+            const point_bub_ms cur = p - offset;
+            if( cur.x() < 0 || cur.x() >= size || cur.y() < 0 || cur.y() >= size ) {
+                continue;
+            }
+            const int step = extra_cost( tripoint_bub_ms( cur, z ), p3, settings, p_special );
+            if( step < 0 ) {
+                continue;
+            }
+            // Penalize for diagonals, as route() does
+            const int cur_cost = p_cost + step + ( offset.x() != 0 && offset.y() != 0 ? 1 : 0 );
+            if( cur_cost < cost[cur.x()][cur.y()] ) {
+                cost[cur.x()][cur.y()] = cur_cost;
+                open.emplace_back( cur_cost, cur );
+                std::push_heap( open.begin(), open.end(), pair_greater_cmp_first() );
+            }
+        }
+    }
+
+    return &field;
+}
+
+std::vector<tripoint_bub_ms> map::route_shared( const Creature &who,
+        const pathfinding_target &target ) const
+{
+    return route_shared( who.pos_bub(), target, who.get_pathfinding_settings(),
+                         who.get_path_avoid() );
+}
+
+std::vector<tripoint_bub_ms> map::route_shared( const tripoint_bub_ms &f,
+        const pathfinding_target &target, const pathfinding_settings &settings,
+        const std::function<bool( const tripoint_bub_ms & )> &avoid ) const
+{
+    const tripoint_bub_ms &t = target.center;
+    if( f == t || !inbounds( f ) || !inbounds( t ) || f.z() != t.z() ||
+        rl_dist( f, t ) > settings.max_dist ) {
+        return route( f, target, settings, avoid );
+    }
+    std::vector<tripoint_bub_ms> ret = unobstructed_straight_route( f, t, avoid );
+    if( !ret.empty() ) {
+        return ret;
+    }
+
+    // Usually it's the rest of the crowd that's to be avoided, right next to f. Following the
+    // costs would run into that on the first step, so don't bother asking for them.
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( f.z() );
+    for( const point_rel_ms &offset : flow_field_offsets ) {
+        const tripoint_bub_ms p = f + offset;
+        if( inbounds( p ) && !target.contains( p ) &&
+            extra_cost( f, p, settings, pf_cache.special[p.x()][p.y()] ) >= 0 && avoid( p ) ) {
+            return route( f, target, settings, avoid );
+        }
+    }
+
+    const path_flow_field *const shared = get_path_flow_field( target, settings );
+    // Without a field, or when there might be a way around through another z-level
+    if( shared == nullptr || shared->leaves_level ||
+        shared->cost[f.x()][f.y()] > settings.max_length ) {
+        return route( f, target, settings, avoid );
+    }
+    const path_flow_field &field = *shared;
+    // The area route() searches, a cheaper route outside of it isn't one route() would take
+    const int pad = 16;
+    tripoint_bub_ms min( std::min( f.x(), t.x() ) - pad, std::min( f.y(), t.y() ) - pad, f.z() );
+    tripoint_bub_ms max( std::max( f.x(), t.x() ) + pad, std::max( f.y(), t.y() ) + pad, f.z() );
+    clip_to_bounds( min.x(), min.y(), min.z() );
+    clip_to_bounds( max.x(), max.y(), max.z() );
+    tripoint_bub_ms cur = f;
+    while( !target.contains( cur ) ) {
+        // Any neighbour a cheapest route goes through will do, as long as it's not to be avoided
+        const int cur_cost = field.cost[cur.x()][cur.y()];
+        std::optional<tripoint_bub_ms> next;
+        for( const point_rel_ms &offset : flow_field_offsets ) {
+            const tripoint_bub_ms p = cur + offset;
+            if( p.x() < min.x() || p.x() >= max.x() || p.y() < min.y() || p.y() >= max.y() ||
+                field.cost[p.x()][p.y()] >= cur_cost ) {
+                continue;
+            }
+            if( !target.contains( p ) && avoid( p ) ) {
+                continue;
+            }
+            const int step = extra_cost( cur, p, settings, pf_cache.special[p.x()][p.y()] );
+            const int diagonal = offset.x() != 0 && offset.y() != 0 ? 1 : 0;
+            if( step >= 0 && field.cost[p.x()][p.y()] + step + diagonal == cur_cost ) {
+                next = p;
+                break;
+            }
+        }
+        if( !next ) {
+            return route( f, target, settings, avoid );
+        }
+        ret.push_back( *next );
+        cur = *next;
+    }
+    return ret;
+}
+
 bool pathfinding_target::contains( const tripoint_bub_ms &p ) const
 {
     if( r == 0 ) {
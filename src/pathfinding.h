@@ -6,6 +6,7 @@
 #include <optional>
 #include <unordered_set>
 
+#include "calendar.h"
 #include "coordinates.h"
 #include "mdarray.h"
 #include "point.h"
@@ -130,6 +131,9 @@ struct pathfinding_cache {
 
     bool dirty = false;
     std::unordered_set<point_bub_ms> dirty_points;
+    // Goes up whenever anything on the z-level is marked dirty, so what was worked out from the
+    // cache can tell when it's out of date.
+    int generation = 0;
 
     cata::mdarray<PathfindingFlags, point_bub_ms> special;
 };
@@ -187,4 +191,26 @@ struct pathfinding_target {
     }
 };
 
+/**
+ * Cost of the cheapest route to a target from every tile of its z-level, shared by everything
+ * that routes there with the same settings. See map::route_shared().
+ */
+struct path_flow_field {
+    tripoint_bub_ms center;
+    int r = 0;
+    pathfinding_settings settings;
+    // The turn and pathfinding_cache::generation of the z-level the rest is about
+    time_point turn;
+    int generation = 0;
+    // How many routes to the target were asked for since, it's only worked out for a crowd
+    int requests = 0;
+    bool computed = false;
+    // How often the costs were worked out for this target and settings
+    int builds = 0;
+    // route() may climb down a trap ledge the costs reach and find a way through the level below
+    bool leaves_level = false;
+    // INT_MAX where the target can't be reached from
+    cata::mdarray<int, point_bub_ms> cost;
+};
+
 #endif // CATA_SRC_PATHFINDING_H
@@ -0,0 +1,323 @@
+#include "quad_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include "cata_assert.h"
+#include "flexbuffer_json.h"
+#include "json.h"
+#include "json_loader.h"
+#include "map_scale_constants.h"
+#include "string_formatter.h"
+#include "submap.h"
+
+// NOLINTNEXTLINE(cata-static-declarations)
+extern const int savegame_version;
+
+namespace quad_file
+{
+
+namespace
+{
+
+constexpr std::string_view magic = "CDDAQUAD";
+// Bump when the layout of the file changes in a way old readers can't skip over.
+constexpr uint32_t format_version = 1;
+
+enum class section : uint8_t {
+    terrain = 1,
+    furniture = 2,
+    items = 3,
+    // Everything else in the submap, as a json object.
+    other = 4,
+};
+
+// Integers are stored little endian, whatever the platform.
+void put_u8( std::string &out, uint8_t value )
+{
+    out.push_back( static_cast<char>( value ) );
+}
+
+void put_u16( std::string &out, uint16_t value )
+{
+    put_u8( out, value & 0xFF );
+    put_u8( out, value >> 8 );
+}
+
+void put_u32( std::string &out, uint32_t value )
+{
+    put_u16( out, value & 0xFFFF );
+    put_u16( out, value >> 16 );
+}
+
+void put_i32( std::string &out, int32_t value )
+{
+    put_u32( out, static_cast<uint32_t>( value ) );
+}
+
+void put_string( std::string &out, const std::string &str )
+{
+    if( str.size() > UINT16_MAX ) {
+        throw std::runtime_error( string_format( "id %s is too long for a quad file", str ) );
+    }
+    put_u16( out, str.size() );
+    out += str;
+}
+
+class byte_reader
+{
+    public:
+        explicit byte_reader( std::string_view data ) : data( data ) {}
+
+        bool empty() const {
+            return data.empty();
+        }
+        std::string_view rest() {
+            return take( data.size() );
+        }
+        std::string_view take( size_t len ) {
+            if( len > data.size() ) {
+                throw std::runtime_error( "quad file is truncated" );
+            }
+            const std::string_view ret = data.substr( 0, len );
+            data.remove_prefix( len );
+            return ret;
+        }
+        uint8_t u8() {
+            return static_cast<uint8_t>( take( 1 )[0] );
+        }
+        uint16_t u16() {
+            const uint16_t lo = u8();
+            return lo | static_cast<uint16_t>( u8() << 8 );
+        }
+        uint32_t u32() {
+            const uint32_t lo = u16();
+            return lo | static_cast<uint32_t>( u16() ) << 16;
+        }
+        int32_t i32() {
+            return static_cast<int32_t>( u32() );
+        }
+        std::string string() {
+            return std::string( take( u16() ) );
+        }
+
+    private:
+        std::string_view data;
+};
+
+// Writes a section header, and fills in its length once the returned object goes away.
+class section_writer
+{
+    public:
+        section_writer( std::string &out, section kind ) : out( out ) {
+            put_u8( out, static_cast<uint8_t>( kind ) );
+            length_at = out.size();
+            put_u32( out, 0 );
+        }
+        section_writer( const section_writer & ) = delete;
+        section_writer &operator=( const section_writer & ) = delete;
+        ~section_writer() {
+            std::string length;
+            put_u32( length, out.size() - length_at - 4 );
+            out.replace( length_at, 4, length );
+        }
+
+    private:
+        std::string &out;
+        size_t length_at;
+};
+
+/**
+ * One id per tile of the submap, as the list of distinct ids followed by runs of
+ * ( index in the list, run length ) in row order.
+ */
+template<typename Id, typename IdToString>
+void write_grid( std::string &out, const std::vector<Id> &tiles, IdToString id_to_string )
+{
+    std::vector<Id> ids;
+    std::vector<std::pair<uint16_t, uint16_t>> runs;
+    for( const Id &tile : tiles ) {
+        const uint16_t index = std::find( ids.begin(), ids.end(), tile ) - ids.begin();
+        if( index == ids.size() ) {
+            ids.push_back( tile );
+        }
+        if( !runs.empty() && runs.back().first == index ) {
+            runs.back().second++;
+        } else {
+            runs.emplace_back( index, 1 );
+        }
+    }
+    put_u16( out, ids.size() );
+    for( const Id &id : ids ) {
+        put_string( out, id_to_string( id ) );
+    }
+    put_u16( out, runs.size() );
+    for( const std::pair<uint16_t, uint16_t> &run : runs ) {
+        put_u16( out, run.first );
+        put_u16( out, run.second );
+    }
+}
+
+void read_grid( byte_reader &in, std::vector<std::string> &ids, std::vector<uint16_t> &tiles )
+{
+    ids.resize( in.u16() );
+    for( std::string &id : ids ) {
+        id = in.string();
+    }
+    tiles.clear();
+    tiles.reserve( SEEX * SEEY );
+    for( uint16_t num_runs = in.u16(); num_runs > 0; --num_runs ) {
+        const uint16_t index = in.u16();
+        const uint16_t length = in.u16();
+        if( index >= ids.size() || tiles.size() + length > SEEX * SEEY ) {
+            throw std::runtime_error( "quad file has corrupt terrain or furniture data" );
+        }
+        tiles.insert( tiles.end(), length, index );
+    }
+    if( tiles.size() != SEEX * SEEY ) {
+        throw std::runtime_error( "quad file has corrupt terrain or furniture data" );
+    }
+}
+
+void write_submap( std::string &out, const tripoint_abs_sm &pos, const submap &sm,
+                   const submap_json &json )
+{
+    put_i32( out, pos.x() );
+    put_i32( out, pos.y() );
+    put_i32( out, pos.z() );
+    put_i32( out, savegame_version );
+
+    const bool uniform = sm.is_uniform();
+    put_u8( out, uniform ? 2 : 4 );
+    {
+        std::vector<ter_id> ter( SEEX * SEEY );
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                ter[j * SEEX + i] = sm.get_ter( point_sm_ms( i, j ) );
+            }
+        }
+        section_writer terrain( out, section::terrain );
+        write_grid( out, ter, []( const ter_id & id ) {
+            return id.id().str();
+        } );
+    }
+    if( !uniform ) {
+        std::vector<furn_id> furn( SEEX * SEEY );
+        for( int j = 0; j < SEEY; j++ ) {
+            for( int i = 0; i < SEEX; i++ ) {
+                furn[j * SEEX + i] = sm.get_furn( point_sm_ms( i, j ) );
+            }
+        }
+        section_writer furniture( out, section::furniture );
+        write_grid( out, furn, []( const furn_id & id ) {
+            return id ? id.id().str() : std::string();
+        } );
+    }
+    if( !uniform ) {
+        section_writer items( out, section::items );
+        out += json.items;
+    }
+    section_writer other( out, section::other );
+    out += json.other;
+}
+
+} // namespace
+
+submap_json serialize_json( const submap &sm )
+{
+    submap_json json;
+    if( !sm.is_uniform() ) {
+        JsonOut jsout( json.items );
+        sm.store_items( jsout );
+    }
+    JsonOut jsout( json.other );
+    jsout.start_object();
+    sm.store_other( jsout );
+    jsout.end_object();
+    return json;
+}
+
+bool is_binary( std::string_view data )
+{
+    return data.substr( 0, magic.size() ) == magic;
+}
+
+std::string write( const std::vector<std::pair<tripoint_abs_sm, const submap *>> &submaps,
+                   const std::vector<submap_json> &json )
+{
+    cata_assert( submaps.size() == json.size() );
+    std::string out( magic );
+    put_u32( out, format_version );
+    put_u8( out, submaps.size() );
+    for( size_t i = 0; i < submaps.size(); ++i ) {
+        write_submap( out, submaps[i].first, *submaps[i].second, json[i] );
+    }
+    return out;
+}
+
+std::string write( const std::vector<std::pair<tripoint_abs_sm, const submap *>> &submaps )
+{
+    std::vector<submap_json> json;
+    json.reserve( submaps.size() );
+    for( const std::pair<tripoint_abs_sm, const submap *> &elem : submaps ) {
+        json.push_back( serialize_json( *elem.second ) );
+    }
+    return write( submaps, json );
+}
+
+void read( std::string_view data,
+           const std::function<void( const tripoint_abs_sm &, std::unique_ptr<submap> & )> &add )
+{
+    if( !is_binary( data ) ) {
+        throw std::runtime_error( "not a binary quad file" );
+    }
+    byte_reader in( data );
+    in.take( magic.size() );
+    const uint32_t version = in.u32();
+    if( version > format_version ) {
+        throw std::runtime_error( string_format( "quad file format %d is newer than this game", version ) );
+    }
+
+    std::vector<std::string> ids;
+    std::vector<uint16_t> tiles;
+    for( uint8_t num_submaps = in.u8(); num_submaps > 0; --num_submaps ) {
+        const int x = in.i32();
+        const int y = in.i32();
+        const int z = in.i32();
+        const int submap_version = in.i32();
+        std::unique_ptr<submap> sm = std::make_unique<submap>();
+
+        for( uint8_t num_sections = in.u8(); num_sections > 0; --num_sections ) {
+            const section kind = static_cast<section>( in.u8() );
+            byte_reader contents( in.take( in.u32() ) );
+            switch( kind ) {
+                case section::terrain:
+                    read_grid( contents, ids, tiles );
+                    sm->load_terrain( ids, tiles );
+                    break;
+                case section::furniture:
+                    read_grid( contents, ids, tiles );
+                    sm->load_furniture( ids, tiles );
+                    break;
+                case section::items:
+                    sm->load( json_loader::from_string( std::string( contents.rest() ) ), "items",
+                              submap_version );
+                    break;
+                case section::other: {
+                    JsonObject jo = json_loader::from_string( std::string( contents.rest() ) );
+                    for( JsonMember member : jo ) {
+                        sm->load( member, member.name(), submap_version );
+                    }
+                    break;
+                }
+                default:
+                    // Written by a newer version, nothing we can do with it
+                    break;
+            }
+        }
+        add( tripoint_abs_sm( x, y, z ), sm );
+    }
+}
+
+} // namespace quad_file
@@ -0,0 +1,66 @@
+#pragma once
+#ifndef CATA_SRC_QUAD_FILE_H
+#define CATA_SRC_QUAD_FILE_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "coordinates.h"
+
+class submap;
+
+/**
+ * Binary format of the map quad files the mapbuffer saves.
+ *
+ * After a header, each submap comes with its coordinates and savegame version and a list of
+ * length prefixed sections. Terrain and furniture are stored as a list of ids plus run length
+ * encoded indices into it; items and the rest of the submap as json text in sections of their
+ * own. Readers skip sections they don't know, so new ones can be added without breaking
+ * older files.
+ *
+ * Quads saved as json by earlier versions are still read by the mapbuffer, see is_binary().
+ */
+namespace quad_file
+{
+
+/** Whether @p data starts like a binary quad file, as opposed to a json one. */
+bool is_binary( std::string_view data );
+
+/** The sections of a submap stored as json text, see serialize_json(). */
+struct submap_json {
+    // Empty for uniform submaps, which have no items section.
+    std::string items;
+    std::string other;
+};
+
+/**
+ * Serialize the items, vehicles and everything else of @p sm that's stored as json.
+ * That reaches into game state (vehicles look up the map, items may report errors), so
+ * it has to run on the main thread.
+ */
+submap_json serialize_json( const submap &sm );
+
+/**
+ * Lay out the file of @p submaps, given their json sections in the same order.
+ * This only reads terrain and furniture of the submaps, so worker threads can run it
+ * while the main thread leaves the submaps alone.
+ */
+std::string write( const std::vector<std::pair<tripoint_abs_sm, const submap *>> &submaps,
+                   const std::vector<submap_json> &json );
+/** Same as above, serializing the json sections on the calling thread. */
+std::string write( const std::vector<std::pair<tripoint_abs_sm, const submap *>> &submaps );
+
+/**
+ * Decode the submaps in @p data and pass each to @p add, in file order.
+ * @throws std::exception if the data is truncated or otherwise malformed.
+ */
+void read( std::string_view data,
+           const std::function<void( const tripoint_abs_sm &, std::unique_ptr<submap> & )> &add );
+
+} // namespace quad_file
+
+#endif // CATA_SRC_QUAD_FILE_H
@@ -69,7 +69,7 @@ extern std::map<std::string, std::list<input_event>> quick_shortcuts_map;
  * Changes that break backwards compatibility should bump this number, so the game can
  * load a legacy format loader.
  */
-const int savegame_version = 36;
+const int savegame_version = 37;
 
 /*
  * This is a global set by detected version header in .sav, maps.txt, or overmap.
@@ -1744,7 +1744,8 @@ void faction_manager::deserialize( const JsonValue &jv )
 void creature_tracker::deserialize( const JsonArray &ja )
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    monsters_list_order.clear();
+    clear_locations();
     for( JsonValue jv : ja ) {
         // TODO: would be nice if monster had a constructor using JsonIn or similar, so this could be one statement.
         shared_ptr_fast<monster> mptr = make_shared_fast<monster>();
@@ -4716,6 +4716,36 @@ void _write_rle_terrain( JsonOut &jsout, std::string_view ter, int num )
 static std::unordered_map<ter_str_id, std::pair<ter_str_id, furn_str_id>> ter_migrations;
 static std::unordered_map<furn_str_id, std::pair<ter_str_id, furn_str_id>> furn_migrations;
 
+// Terrain to place for a saved terrain id, along with the furniture the migration adds, if any.
+static std::pair<ter_id, furn_id> migrate_saved_ter( ter_str_id terstr )
+{
+    furn_id iid_furn = furn_str_id::NULL_ID().id();
+    if( auto it = ter_migrations.find( terstr ); it != ter_migrations.end() ) {
+        terstr = it->second.first;
+        iid_furn = it->second.second.id();
+    }
+    if( terstr.is_valid() ) {
+        return { terstr.id(), iid_furn };
+    }
+    debugmsg( "invalid ter_str_id '%s'", terstr.c_str() );
+    return { ter_t_dirt.id(), iid_furn };
+}
+
+// Furniture to place for a saved furniture id, along with the terrain the migration sets, if any.
+static std::pair<ter_id, furn_id> migrate_saved_furn( furn_str_id furnstr )
+{
+    ter_id iid_ter = ter_str_id::NULL_ID().id();
+    if( auto it = furn_migrations.find( furnstr ); it != furn_migrations.end() ) {
+        furnstr = it->second.second;
+        iid_ter = it->second.first.id();
+    }
+    if( furnstr.is_valid() ) {
+        return { iid_ter, furnstr.id() };
+    }
+    debugmsg( "invalid furn_str_id '%s'", furnstr.c_str() );
+    return { iid_ter, furn_str_id::NULL_ID().id() };
+}
+
 void ter_furn_migrations::load( const JsonObject &jo )
 {
     //TODO: Add support for migrating to items?
@@ -4821,8 +4851,7 @@ void field_type_migrations::check()
 
 void submap::store( JsonOut &jsout ) const
 {
-    jsout.member( "turn_last_touched", last_touched );
-    jsout.member( "temperature", temperature_mod );
+    store_header( jsout );
 
     // Terrain is saved using a simple RLE scheme.  Legacy saves don't have
     // this feature but the algorithm is backward compatible.
@@ -4868,31 +4897,7 @@ void submap::store( JsonOut &jsout ) const
     }
     jsout.end_array();
 
-    // Write out the radiation array in a simple RLE scheme.
-    // written in intensity, count pairs
-    jsout.member( "radiation" );
-    jsout.start_array();
-    int lastrad = -1;
-    int count = 0;
-    for( int j = 0; j < SEEY; j++ ) {
-        for( int i = 0; i < SEEX; i++ ) {
-            const point_sm_ms p( i, j );
-            // Save radiation, re-examine this because it doesn't look like it works right
-            int r = get_radiation( p );
-            if( r == lastrad ) {
-                count++;
-            } else {
-                if( count ) {
-                    jsout.write( count );
-                }
-                jsout.write( r );
-                lastrad = r;
-                count = 1;
-            }
-        }
-    }
-    jsout.write( count );
-    jsout.end_array();
+    store_radiation( jsout );
 
     jsout.member( "furniture" );
     jsout.start_array();
@@ -4912,7 +4917,18 @@ void submap::store( JsonOut &jsout ) const
     jsout.end_array();
 
     jsout.member( "items" );
+    store_items( jsout );
+
+    store_trailing( jsout );
+}
+
+void submap::store_items( JsonOut &jsout ) const
+{
     jsout.start_array();
+    if( is_uniform() ) {
+        jsout.end_array();
+        return;
+    }
     for( int j = 0; j < SEEY; j++ ) {
         for( int i = 0; i < SEEX; i++ ) {
             if( m->itm[i][j].empty() ) {
@@ -4924,7 +4940,55 @@ void submap::store( JsonOut &jsout ) const
         }
     }
     jsout.end_array();
+}
+
+void submap::store_other( JsonOut &jsout ) const
+{
+    store_header( jsout );
+    if( is_uniform() ) {
+        return;
+    }
+    store_radiation( jsout );
+    store_trailing( jsout );
+}
 
+void submap::store_header( JsonOut &jsout ) const
+{
+    jsout.member( "turn_last_touched", last_touched );
+    jsout.member( "temperature", temperature_mod );
+}
+
+void submap::store_radiation( JsonOut &jsout ) const
+{
+    // Write out the radiation array in a simple RLE scheme.
+    // written in intensity, count pairs
+    jsout.member( "radiation" );
+    jsout.start_array();
+    int lastrad = -1;
+    int count = 0;
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const point_sm_ms p( i, j );
+            // Save radiation, re-examine this because it doesn't look like it works right
+            int r = get_radiation( p );
+            if( r == lastrad ) {
+                count++;
+            } else {
+                if( count ) {
+                    jsout.write( count );
+                }
+                jsout.write( r );
+                lastrad = r;
+                count = 1;
+            }
+        }
+    }
+    jsout.write( count );
+    jsout.end_array();
+}
+
+void submap::store_trailing( JsonOut &jsout ) const
+{
     jsout.member( "traps" );
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
@@ -5091,19 +5155,8 @@ void submap::load( const JsonValue &jv, const std::string &member_name, int vers
                 for( int i = 0; i < SEEX; i++ ) {
                     if( !remaining ) {
                         JsonValue terrain_entry = terrain_json.next_value();
-                        auto migrate_terstr = [&]( ter_str_id terstr ) {
-                            if( auto it = ter_migrations.find( terstr ); it != ter_migrations.end() ) {
-                                terstr = it->second.first;
-                                iid_furn = it->second.second.id();
-                            } else {
-                                iid_furn = furn_str_id::NULL_ID().id();
-                            }
-                            if( terstr.is_valid() ) {
-                                iid_ter = terstr.id();
-                            } else {
-                                debugmsg( "invalid ter_str_id '%s'", terstr.c_str() );
-                                iid_ter = ter_t_dirt;
-                            }
+                        auto migrate_terstr = [&]( const ter_str_id & terstr ) {
+                            std::tie( iid_ter, iid_furn ) = migrate_saved_ter( terstr );
                         };
                         if( terrain_entry.test_string() ) {
                             migrate_terstr( ter_str_id( terrain_entry.get_string() ) );
@@ -5150,18 +5203,9 @@ void submap::load( const JsonValue &jv, const std::string &member_name, int vers
         for( JsonArray furniture_entry : furniture_json ) {
             int i = furniture_entry.next_int();
             int j = furniture_entry.next_int();
-            furn_str_id furnstr( furniture_entry.next_string() );
-            if( auto it = furn_migrations.find( furnstr ); it != furn_migrations.end() ) {
-                furnstr = it->second.second;
-                if( it->second.first != ter_str_id::NULL_ID() ) {
-                    m->ter[i][j] = it->second.first.id();
-                }
-            }
-            if( furnstr.is_valid() ) {
-                iid_furn = furnstr.id();
-            } else {
-                debugmsg( "invalid furn_str_id '%s'", furnstr.c_str() );
-                iid_furn = furn_str_id::NULL_ID().id();
+            std::tie( iid_ter, iid_furn ) = migrate_saved_furn( furn_str_id( furniture_entry.next_string() ) );
+            if( iid_ter ) {
+                m->ter[i][j] = iid_ter;
             }
             m->frn[i][j] = iid_furn;
             if( furniture_entry.size() > 3 ) {
@@ -5228,6 +5272,7 @@ void submap::load( const JsonValue &jv, const std::string &member_name, int vers
                     } else if( ft != field_type_str_id::NULL_ID() &&
                                m->fld[i][j].add_field( ft.id(), intensity, time_duration::from_turns( age ) ) ) {
                         field_count++;
+                        field_tiles.set( field_tile_index( { i, j } ) );
                     }
                 } else { // Handle removed int enum method
                     field_json.next_value(); // Skip intensity
@@ -5345,3 +5390,50 @@ void submap::load( const JsonValue &jv, const std::string &member_name, int vers
         camp->deserialize( jv );
     }
 }
+
+void submap::load_terrain( const std::vector<std::string> &ids, const std::vector<uint16_t> &tiles )
+{
+    ensure_nonuniform();
+    // Migrations only need to be looked up once per distinct id
+    std::vector<std::pair<ter_id, furn_id>> migrated;
+    migrated.reserve( ids.size() );
+    for( const std::string &id : ids ) {
+        migrated.push_back( migrate_saved_ter( ter_str_id( id ) ) );
+    }
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const std::pair<ter_id, furn_id> &tile = migrated[tiles[j * SEEX + i]];
+            m->ter[i][j] = tile.first;
+            if( tile.second ) {
+                m->frn[i][j] = tile.second;
+            }
+        }
+    }
+}
+
+void submap::load_furniture( const std::vector<std::string> &ids,
+                             const std::vector<uint16_t> &tiles )
+{
+    ensure_nonuniform();
+    std::vector<std::optional<std::pair<ter_id, furn_id>>> migrated;
+    migrated.reserve( ids.size() );
+    for( const std::string &id : ids ) {
+        if( id.empty() ) {
+            migrated.emplace_back( std::nullopt );
+        } else {
+            migrated.emplace_back( migrate_saved_furn( furn_str_id( id ) ) );
+        }
+    }
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const std::optional<std::pair<ter_id, furn_id>> &tile = migrated[tiles[j * SEEX + i]];
+            if( !tile ) {
+                continue;
+            }
+            if( tile->first ) {
+                m->ter[i][j] = tile->first;
+            }
+            m->frn[i][j] = tile->second;
+        }
+    }
+}
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <utility>
 
 #include "assign.h"
 #include "calendar.h"
@@ -55,6 +56,7 @@ void scent_map::reset()
         }
     }
     typescent = scenttype_id();
+    blockers_generation.reset();
 }
 
 void scent_map::decay()
@@ -178,18 +180,6 @@ void scent_map::update( const tripoint_bub_ms &center, map &m )
         return;
     }
 
-    // note: the next four intermediate matrices need to be at least
-    // [2*SCENT_RADIUS+3][2*SCENT_RADIUS+1] in size to hold enough data
-    // The code I'm modifying used [MAPSIZE_X]. I'm staying with that to avoid new bugs.
-
-    // These two matrices are transposed so that x addresses are contiguous in memory
-    scent_array<int> sum_3_scent_y;
-    scent_array<int> squares_used_y;
-
-    // these are for caching flag lookups
-    scent_array<bool> blocks_scent; // currently only ter_furn_flag::TFLAG_NO_SCENT blocks scent
-    scent_array<bool> reduces_scent;
-
     // for loop constants
     const int scentmap_minx = center.x() - SCENT_RADIUS;
     const int scentmap_maxx = center.x() + SCENT_RADIUS;
@@ -200,73 +190,86 @@ void scent_map::update( const tripoint_bub_ms &center, map &m )
     // stability. This is essentially a decimal number * 1000.
     const int diffusivity = 100;
 
-    // The new scent flag searching function. Should be wayyy faster than the old one.
-    m.scent_blockers( blocks_scent, reduces_scent, point_bub_ms( scentmap_minx - 1, scentmap_miny - 1 ),
-                      point_bub_ms( scentmap_maxx + 1, scentmap_maxy + 1 ) );
-    // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
-    // times. This cost us an extra loop here, but it also eliminated a loop at the end, so there
-    // is a net performance improvement over the old code. Could probably still be better.
-    // note: this method needs an array that is one square larger on each side in the x direction
+    update_blockers( m );
+    // Vehicles move around all the time, so they are looked up every turn
+    scent_array<bool> reduces_scent = terrain_reduces_scent;
+    m.vehicle_scent_reducers( reduces_scent, point_bub_ms( scentmap_minx - 1, scentmap_miny - 1 ),
+                              point_bub_ms( scentmap_maxx + 1, scentmap_maxy + 1 ) );
+
+    // How much of its scent each square passes on: none on NO_SCENT squares, only 20% on
+    // REDUCE_SCENT ones. It is also how much of the air movement a square gets, in tenths of
+    // diffusivity.
+    // All the loops below go along y, which is contiguous in memory, and don't branch, so the
+    // compiler can vectorize them.
+    for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
+        const bool *blocks = terrain_blocks_scent[x].data();
+        const bool *reduces = reduces_scent[x].data();
+        const int *scent = grscent[x].data();
+        int *w = weight[x].data();
+        int *ws = weighted_scent[x].data();
+        for( int y = scentmap_miny - 1; y <= scentmap_maxy + 1; ++y ) {
+            w[y] = blocks[y] ? 0 : reduces[y] ? 2 : 10;
+            ws[y] = w[y] * scent[y];
+        }
+    }
+
+    // Sum neighbors in the y direction, and then in the x direction below, so each square
+    // gets added up 6 times instead of 9.
+    // note: this needs the arrays to be one square larger on each side in the x direction
     // than the final scent matrix. I think this is fine since SCENT_RADIUS is less than
     // MAPSIZE_X, but if that changes, this may need tweaking.
     for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
+        const int *w = weight[x].data();
+        const int *ws = weighted_scent[x].data();
+        int *sum = sum_3_scent_y[x].data();
+        int *used = squares_used_y[x].data();
         for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
-            // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for( int i = y - 1; i <= y + 1; ++i ) {
-                if( !blocks_scent[x][i] ) {
-                    if( reduces_scent[x][i] ) {
-                        // only 20% of scent can diffuse on REDUCE_SCENT squares
-                        sum_3_scent_y[y][x] += 2 * grscent[x][i];
-                        squares_used_y[y][x] += 2;
-                    } else {
-                        sum_3_scent_y[y][x] += 10 * grscent[x][i];
-                        squares_used_y[y][x] += 10;
-                    }
-                }
-            }
+            sum[y] = ws[y - 1] + ws[y] + ws[y + 1];
+            used[y] = w[y - 1] + w[y] + w[y + 1];
         }
     }
 
     // Rest of the scent map
     for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
+        const int *w = weight[x].data();
+        const int *sum_left = sum_3_scent_y[x - 1].data();
+        const int *sum_here = sum_3_scent_y[x].data();
+        const int *sum_right = sum_3_scent_y[x + 1].data();
+        const int *used_left = squares_used_y[x - 1].data();
+        const int *used_here = squares_used_y[x].data();
+        const int *used_right = squares_used_y[x + 1].data();
+        int *scent = grscent[x].data();
         for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
-            int &scent_here = grscent[x][y];
-            if( !blocks_scent[x][y] ) {
-                // to how many neighboring squares do we diffuse out? (include our own square
-                // since we also include our own square when diffusing in)
-                const int squares_used = squares_used_y[y][x - 1]
-                                         + squares_used_y[y][x]
-                                         + squares_used_y[y][x + 1];
-
-                int this_diffusivity;
-                if( !reduces_scent[x][y] ) {
-                    this_diffusivity = diffusivity;
-                } else {
-                    this_diffusivity = diffusivity / 5; //less air movement for REDUCE_SCENT square
-                }
-                // take the old scent and subtract what diffuses out
-                int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
-                // neighboring REDUCE_SCENT squares absorb some scent
-                temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
-                // we've already summed neighboring scent values in the y direction in the previous
-                // loop. Now we do it for the x direction, multiply by diffusion, and this is what
-                // diffuses into our current square.
-                scent_here =
-                    ( temp_scent
-                      + this_diffusivity * ( sum_3_scent_y[y][x - 1]
-                                             + sum_3_scent_y[y][x]
-                                             + sum_3_scent_y[y][x + 1] )
-                    ) / ( 1000 * 10 );
-            } else {
-                // this cell blocks scent via NO_SCENT (in json)
-                scent_here = 0;
-            }
+            // to how many neighboring squares do we diffuse out? (include our own square
+            // since we also include our own square when diffusing in)
+            const int squares_used = used_left[y] + used_here[y] + used_right[y];
+            // less air movement for REDUCE_SCENT square
+            const int this_diffusivity = w[y] * diffusivity / 10;
+            const int scent_here = scent[y];
+            // take the old scent and subtract what diffuses out
+            int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+            // neighboring REDUCE_SCENT squares absorb some scent
+            temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+            // what diffuses in from the neighboring squares
+            temp_scent += this_diffusivity * ( sum_left[y] + sum_here[y] + sum_right[y] );
+            // NO_SCENT (in json) squares don't hold on to any
+            scent[y] = w[y] == 0 ? 0 : temp_scent / ( 1000 * 10 );
         }
     }
 }
 
+void scent_map::update_blockers( map &m )
+{
+    const int zlev = m.get_abs_sub().z();
+    const std::pair<int, int> generation( zlev, m.get_pathfinding_generation( zlev ) );
+    if( blockers_generation == generation ) {
+        return;
+    }
+    m.scent_blockers( terrain_blocks_scent, terrain_reduces_scent, point_bub_ms::zero,
+                      point_bub_ms( MAPSIZE_X - 1, MAPSIZE_Y - 1 ) );
+    blockers_generation = generation;
+}
+
 namespace
 {
 generic_factory<scent_type> scent_factory( "scent_type" );
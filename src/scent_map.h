@@ -56,6 +56,21 @@ class scent_map
 
         const game &gm; // NOLINT(cata-serialize)
 
+        // Terrain and furniture that block or reduce scent, for the whole reality bubble. Only
+        // looked up again when the z-level or map::get_pathfinding_generation() changes.
+        scent_array<bool> terrain_blocks_scent; // NOLINT(cata-serialize)
+        scent_array<bool> terrain_reduces_scent; // NOLINT(cata-serialize)
+        // z-level and generation the above were looked up for
+        std::optional<std::pair<int, int>> blockers_generation; // NOLINT(cata-serialize)
+
+        // Scratch space for update(), kept so it needn't be set up again every turn
+        scent_array<int> weight; // NOLINT(cata-serialize)
+        scent_array<int> weighted_scent; // NOLINT(cata-serialize)
+        scent_array<int> sum_3_scent_y; // NOLINT(cata-serialize)
+        scent_array<int> squares_used_y; // NOLINT(cata-serialize)
+
+        void update_blockers( map &m );
+
     public:
         explicit scent_map( const game &g ) : gm( g ) { }
 
@@ -14,6 +14,12 @@
 #include "point.h"
 #include "sdltiles.h"
 
+// SSE2 is part of every x86-64 target, so no runtime detection is needed for it.
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define CATA_COLOR_FILTER_SSE2
+#include <emmintrin.h>
+#endif
+
 static color_pixel_function_map builtin_color_pixel_functions = {
     { "color_pixel_none", nullptr },
     { "color_pixel_darken", color_pixel_darken },
@@ -148,6 +154,174 @@ inline SDL_Color color_pixel_mixer( const SDL_Color &color, const float &gammav,
     return mix_colors( color_a, color_b, finalv );
 }
 
+namespace
+{
+
+using color_filter_kernel = void( * )( SDL_Color *pixels, size_t count,
+                                       color_pixel_function_pointer filter );
+
+void filter_per_pixel( SDL_Color *pixels, size_t count, color_pixel_function_pointer filter )
+{
+    for( SDL_Color *pix = pixels, *end = pixels + count; pix != end; ++pix ) {
+        // Vast majority of pixels in the tilesets are completely transparent.
+        if( pix->a != 0x00 ) {
+            *pix = filter( *pix );
+        }
+    }
+}
+
+// Any color with the given sum of r, g and b.
+SDL_Color color_with_sum( int sum )
+{
+    return {
+        static_cast<Uint8>( std::min( sum, 0xFF ) ),
+        static_cast<Uint8>( std::clamp( sum - 0xFF, 0, 0xFF ) ),
+        static_cast<Uint8>( std::max( sum - 0x1FE, 0 ) ),
+        0xFF
+    };
+}
+
+/**
+ * For filters that only look at the average pixel color and at whether the pixel is black,
+ * and that keep the alpha as is: run the filter once per possible average instead of once
+ * per pixel. Mostly pays off for the memory filters, which do a pow() or option lookups.
+ */
+void filter_by_average( SDL_Color *pixels, size_t count, color_pixel_function_pointer filter )
+{
+    std::array<SDL_Color, 0x100> by_average{};
+    for( int sum = 3 * 0xFF; sum > 0; --sum ) {
+        const SDL_Color color = color_with_sum( sum );
+        by_average[average_pixel_color( color )] = filter( color );
+    }
+    const SDL_Color black = filter( color_with_sum( 0 ) );
+
+    for( SDL_Color *pix = pixels, *end = pixels + count; pix != end; ++pix ) {
+        if( pix->a == 0x00 ) {
+            continue;
+        }
+        const SDL_Color &result = is_black( *pix ) ? black : by_average[average_pixel_color( *pix )];
+        pix->r = result.r;
+        pix->g = result.g;
+        pix->b = result.b;
+    }
+}
+
+#if defined(CATA_COLOR_FILTER_SSE2)
+
+// The shades below get the average pixel color in each 32 bit lane and return the packed
+// rgb. All intermediate values fit in 16 bits, so the 16 bit multiply / min / max work on them.
+
+__m128i pack_rgb( const __m128i &r, const __m128i &g, const __m128i &b )
+{
+    return _mm_or_si128( r, _mm_or_si128( _mm_slli_epi32( g, 8 ), _mm_slli_epi32( b, 16 ) ) );
+}
+
+struct grayscale_shade {
+    static constexpr bool keeps_black = true;
+
+    static __m128i apply( const __m128i &av ) {
+        // std::max( av * 5 >> 3, 0x01 )
+        const __m128i av5 = _mm_add_epi32( _mm_slli_epi32( av, 2 ), av );
+        const __m128i result = _mm_max_epi16( _mm_srli_epi32( av5, 3 ), _mm_set1_epi32( 0x01 ) );
+        return pack_rgb( result, result, result );
+    }
+};
+
+struct nightvision_shade {
+    static constexpr bool keeps_black = false;
+
+    static __m128i apply( const __m128i &av ) {
+        // std::min( ( av * ( ( av * 3 >> 2 ) + 64 ) >> 8 ) + 16, 0xFF )
+        const __m128i av3 = _mm_add_epi32( _mm_slli_epi32( av, 1 ), av );
+        const __m128i factor = _mm_add_epi32( _mm_srli_epi32( av3, 2 ), _mm_set1_epi32( 64 ) );
+        const __m128i scaled = _mm_srli_epi32( _mm_mullo_epi16( av, factor ), 8 );
+        const __m128i result = _mm_min_epi16( _mm_add_epi32( scaled, _mm_set1_epi32( 16 ) ),
+                                              _mm_set1_epi32( 0xFF ) );
+        return pack_rgb( _mm_srli_epi32( result, 2 ), result, _mm_srli_epi32( result, 3 ) );
+    }
+};
+
+struct overexposed_shade {
+    static constexpr bool keeps_black = false;
+
+    static __m128i apply( const __m128i &av ) {
+        // std::min( 64 + ( av * ( ( av >> 2 ) + 0xC0 ) >> 8 ), 0xFF )
+        const __m128i factor = _mm_add_epi32( _mm_srli_epi32( av, 2 ), _mm_set1_epi32( 0xC0 ) );
+        const __m128i scaled = _mm_srli_epi32( _mm_mullo_epi16( av, factor ), 8 );
+        const __m128i result = _mm_min_epi16( _mm_add_epi32( scaled, _mm_set1_epi32( 64 ) ),
+                                              _mm_set1_epi32( 0xFF ) );
+        return pack_rgb( _mm_srli_epi32( result, 2 ), result, _mm_srli_epi32( result, 3 ) );
+    }
+};
+
+template<typename Shade>
+void filter_sse2( SDL_Color *pixels, size_t count, color_pixel_function_pointer filter )
+{
+    static_assert( sizeof( SDL_Color ) == 4, "SDL_Color is expected to be packed rgba" );
+    // SDL_Color is r, g, b, a in memory, so loaded as little endian 32 bit lanes a is the top byte.
+    const __m128i byte_mask = _mm_set1_epi32( 0xFF );
+    const __m128i alpha_mask = _mm_set1_epi32( static_cast<int>( 0xFF000000 ) );
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for( ; i + 4 <= count; i += 4 ) {
+        __m128i *const p = reinterpret_cast<__m128i *>( pixels + i );
+        const __m128i px = _mm_loadu_si128( p );
+        const __m128i sum = _mm_add_epi32(
+                                _mm_add_epi32( _mm_and_si128( px, byte_mask ),
+                                               _mm_and_si128( _mm_srli_epi32( px, 8 ), byte_mask ) ),
+                                _mm_and_si128( _mm_srli_epi32( px, 16 ), byte_mask ) );
+        // 85 * sum >> 8, with 85 = 64 + 16 + 4 + 1
+        const __m128i av = _mm_srli_epi32(
+                               _mm_add_epi32( _mm_add_epi32( _mm_slli_epi32( sum, 6 ), _mm_slli_epi32( sum, 4 ) ),
+                                              _mm_add_epi32( _mm_slli_epi32( sum, 2 ), sum ) ), 8 );
+        const __m128i alpha = _mm_and_si128( px, alpha_mask );
+        const __m128i filtered = _mm_or_si128( Shade::apply( av ), alpha );
+
+        __m128i keep = _mm_cmpeq_epi32( alpha, zero );
+        if( Shade::keeps_black ) {
+            keep = _mm_or_si128( keep, _mm_cmpeq_epi32( _mm_andnot_si128( alpha_mask, px ), zero ) );
+        }
+        _mm_storeu_si128( p, _mm_or_si128( _mm_and_si128( keep, px ),
+                                           _mm_andnot_si128( keep, filtered ) ) );
+    }
+    filter_per_pixel( pixels + i, count - i, filter );
+}
+
+#endif // CATA_COLOR_FILTER_SSE2
+
+const std::array<std::pair<color_pixel_function_pointer, color_filter_kernel>, 7>
+color_filter_kernels = {{
+#if defined(CATA_COLOR_FILTER_SSE2)
+        { color_pixel_grayscale, filter_sse2<grayscale_shade> },
+        { color_pixel_nightvision, filter_sse2<nightvision_shade> },
+        { color_pixel_overexposed, filter_sse2<overexposed_shade> },
+#else
+        { color_pixel_grayscale, filter_by_average },
+        { color_pixel_nightvision, filter_by_average },
+        { color_pixel_overexposed, filter_by_average },
+#endif
+        { color_pixel_sepia_light, filter_by_average },
+        { color_pixel_sepia_dark, filter_by_average },
+        { color_pixel_blue_dark, filter_by_average },
+        { color_pixel_custom, filter_by_average },
+    }
+};
+
+} // namespace
+
+void apply_color_filter( SDL_Color *pixels, size_t count, color_pixel_function_pointer filter )
+{
+    color_filter_kernel kernel = filter_per_pixel;
+    for( const auto &it : color_filter_kernels ) {
+        if( it.first == filter ) {
+            kernel = it.second;
+            break;
+        }
+    }
+    kernel( pixels, count, filter );
+}
+
 SDL_Color curses_color_to_SDL( const nc_color &color )
 {
     const int pair_id = color.to_color_pair_index();
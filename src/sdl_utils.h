@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_SDL_UTILS_H
 #define CATA_SRC_SDL_UTILS_H
 
+#include <cstddef>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -68,6 +69,14 @@ inline SDL_Color color_pixel_custom( const SDL_Color &color )
     return color_pixel_mixer( color, get_option<float>( "MEMORY_GAMMA" ), dark, light );
 }
 
+/**
+ * Apply @p filter in place to @p count consecutive pixels, leaving fully transparent ones alone.
+ * The builtin filters go through specialised kernels: SSE2 for grayscale, night vision and
+ * overexposed where the target has it, and a table on the average pixel color for the memory
+ * filters. The result is always identical to calling @p filter on every pixel.
+ */
+void apply_color_filter( SDL_Color *pixels, size_t count, color_pixel_function_pointer filter );
+
 SDL_Color curses_color_to_SDL( const nc_color &color );
 
 ///@throws std::exception upon errors.
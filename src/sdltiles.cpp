@@ -767,6 +767,8 @@ void cata_tiles::draw_om( const point &dest, const tripoint_abs_omt &center_abs_
         return;
     }
 
+    cache.upload_filtered_variants();
+
 #if defined(__ANDROID__)
     // Attempted bugfix for Google Play crash - prevent divide-by-zero if no tile
     // width/height specified
@@ -1,16 +1,172 @@
 #include "shadowcasting.h"
 
+#include <condition_variable>
 #include <cstdint>
 #include <cstdlib>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
+#include "cata_scope_helpers.h"
 #include "coordinates.h"
 #include "cuboid_rectangle.h"
 #include "fragment_cloud.h" // IWYU pragma: keep
 #include "line.h"
 #include "list.h"
+#include "options.h"
 #include "point.h"
 
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+// Most threads it's worth spreading shadowcasting over, the jobs are too small for more
+static constexpr int max_shadowcasting_threads = 8;
+
+int shadowcasting_threads( int jobs )
+{
+    int max_threads = get_option<int>( "SHADOWCASTING_THREADS" );
+    if( max_threads == 0 ) {
+        max_threads = std::clamp( static_cast<int>( std::thread::hardware_concurrency() ), 1,
+                                  max_shadowcasting_threads );
+    }
+    return std::clamp( jobs, 1, max_threads );
+}
+
+namespace
+{
+
+/**
+ * The threads shadowcasting jobs run on. They're started the first time they're needed and
+ * then wait for the next batch, shadowcasting runs several times a turn.
+ */
+class shadowcasting_pool
+{
+    public:
+        static shadowcasting_pool &instance() {
+            static shadowcasting_pool pool;
+            return pool;
+        }
+
+        shadowcasting_pool( const shadowcasting_pool & ) = delete;
+        shadowcasting_pool &operator=( const shadowcasting_pool & ) = delete;
+
+        ~shadowcasting_pool() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                stopping = true;
+            }
+            start_cv.notify_all();
+            for( std::thread &worker : workers ) {
+                worker.join();
+            }
+        }
+
+        void run( int num_threads, const std::function<void( int )> &job ) {
+            // Only one batch at a time. A job that casts itself does its share on its own
+            // thread, it mustn't wait for the batch it is part of. So does a second caller,
+            // which is never the thread holding run_mutex.
+            const auto run_inline = [&]() {
+                for( int i = 0; i < num_threads; ++i ) {
+                    job( i );
+                }
+            };
+            if( in_job ) {
+                run_inline();
+                return;
+            }
+            std::unique_lock<std::mutex> running( run_mutex, std::try_to_lock );
+            if( !running.owns_lock() ) {
+                run_inline();
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                while( static_cast<int>( workers.size() ) < num_threads - 1 ) {
+                    const int thread = static_cast<int>( workers.size() ) + 1;
+                    workers.emplace_back( [this, thread]() {
+                        work( thread );
+                    } );
+                }
+                current_job = &job;
+                current_threads = num_threads;
+                num_busy = num_threads - 1;
+                ++batch;
+            }
+            start_cv.notify_all();
+            run_job( job, 0 );
+            std::unique_lock<std::mutex> lock( mutex );
+            done_cv.wait( lock, [this]() {
+                return num_busy == 0;
+            } );
+            current_job = nullptr;
+        }
+
+    private:
+        shadowcasting_pool() = default;
+
+        static void run_job( const std::function<void( int )> &job, int thread ) {
+            in_job = true;
+            on_out_of_scope leave_job( []() {
+                in_job = false;
+            } );
+            job( thread );
+        }
+
+        void work( int thread ) {
+            uint64_t last_batch = 0;
+            std::unique_lock<std::mutex> lock( mutex );
+            while( true ) {
+                start_cv.wait( lock, [&]() {
+                    return stopping || batch != last_batch;
+                } );
+                if( stopping ) {
+                    return;
+                }
+                last_batch = batch;
+                if( thread >= current_threads ) {
+                    continue;
+                }
+                const std::function<void( int )> &job = *current_job;
+                lock.unlock();
+                run_job( job, thread );
+                lock.lock();
+                if( --num_busy == 0 ) {
+                    done_cv.notify_one();
+                }
+            }
+        }
+
+        std::mutex run_mutex;
+        std::mutex mutex;
+        std::condition_variable start_cv;
+        std::condition_variable done_cv;
+        std::vector<std::thread> workers;
+        const std::function<void( int )> *current_job = nullptr;
+        int current_threads = 0;
+        int num_busy = 0;
+        uint64_t batch = 0;
+        bool stopping = false;
+        // Whether this thread is running a job of the current batch
+        static thread_local bool in_job;
+};
+
+thread_local bool shadowcasting_pool::in_job = false;
+
+} // namespace
+
+void run_shadowcasting_jobs( int num_threads, const std::function<void( int )> &job )
+{
+    if( num_threads <= 1 ) {
+        job( 0 );
+        return;
+    }
+    shadowcasting_pool::instance().run( num_threads, job );
+}
+
 // historically 8 bits is enough for rise and run, as a shadowcasting radius of 60
 // readily fits within that space. larger shadowcasting volumes may require larger
 // storage units; a radius of 120 definitely will not fit.
@@ -537,66 +693,73 @@ void cast_zlight(
     const tripoint_bub_ms &origin, const int offset_distance, const T numerator,
     vertical_direction dir )
 {
+    using segment_function = void( * )( const array_of_grids_of<T> &,
+                                        const array_of_grids_of<const T> &,
+                                        const array_of_grids_of<const bool> &,
+                                        const tripoint_bub_ms &, int, T );
+    std::vector<segment_function> segments;
+    segments.reserve( 24 );
+
     if( dir == vertical_direction::DOWN || dir == vertical_direction::BOTH ) {
         // Down lateral
         // @..
         //  ..
         //   .
-        cast_horizontal_zlight_segment < 0, 1, 1, 0, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 0, 1, 1, 0, -1, T, calc,
+                            is_transparent, accumulate > );
         // @
         // ..
         // ...
-        cast_horizontal_zlight_segment < 1, 0, 0, 1, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 1, 0, 0, 1, -1, T, calc,
+                            is_transparent, accumulate > );
         //   .
         //  ..
         // @..
-        cast_horizontal_zlight_segment < 0, -1, 1, 0, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 0, -1, 1, 0, -1, T, calc,
+                            is_transparent, accumulate > );
         // ...
         // ..
         // @
-        cast_horizontal_zlight_segment < -1, 0, 0, 1, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < -1, 0, 0, 1, -1, T, calc,
+                            is_transparent, accumulate > );
         // ..@
         // ..
         // .
-        cast_horizontal_zlight_segment < 0, 1, -1, 0, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 0, 1, -1, 0, -1, T, calc,
+                            is_transparent, accumulate > );
         //   @
         //  ..
         // ...
-        cast_horizontal_zlight_segment < 1, 0, 0, -1, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 1, 0, 0, -1, -1, T, calc,
+                            is_transparent, accumulate > );
         // .
         // ..
         // ..@
-        cast_horizontal_zlight_segment < 0, -1, -1, 0, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 0, -1, -1, 0, -1, T, calc,
+                            is_transparent, accumulate > );
         // ...
         //  ..
         //   @
-        cast_horizontal_zlight_segment < -1, 0, 0, -1, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < -1, 0, 0, -1, -1, T, calc,
+                            is_transparent, accumulate > );
 
         // Straight down
         // @.
         // ..
-        cast_vertical_zlight_segment < 1, 1, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_vertical_zlight_segment < 1, 1, -1, T, calc,
+                            is_transparent, accumulate > );
         // ..
         // @.
-        cast_vertical_zlight_segment < 1, -1, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_vertical_zlight_segment < 1, -1, -1, T, calc,
+                            is_transparent, accumulate > );
         // .@
         // ..
-        cast_vertical_zlight_segment < -1, 1, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_vertical_zlight_segment < -1, 1, -1, T, calc,
+                            is_transparent, accumulate > );
         // ..
         // .@
-        cast_vertical_zlight_segment < -1, -1, -1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_vertical_zlight_segment < -1, -1, -1, T, calc,
+                            is_transparent, accumulate > );
     }
 
     if( dir == vertical_direction::UP || dir == vertical_direction::BOTH ) {
@@ -604,64 +767,109 @@ void cast_zlight(
         // @..
         //  ..
         //   .
-        cast_horizontal_zlight_segment < 0, 1, 1, 0, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 0, 1, 1, 0, 1, T, calc,
+                            is_transparent, accumulate > );
         // @
         // ..
         // ...
-        cast_horizontal_zlight_segment < 1, 0, 0, 1, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 1, 0, 0, 1, 1, T, calc,
+                            is_transparent, accumulate > );
         // ..@
         // ..
         // .
-        cast_horizontal_zlight_segment < 0, -1, 1, 0, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 0, -1, 1, 0, 1, T, calc,
+                            is_transparent, accumulate > );
         //   @
         //  ..
         // ...
-        cast_horizontal_zlight_segment < -1, 0, 0, 1, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < -1, 0, 0, 1, 1, T, calc,
+                            is_transparent, accumulate > );
         //   .
         //  ..
         // @..
-        cast_horizontal_zlight_segment < 0, 1, -1, 0, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 0, 1, -1, 0, 1, T, calc,
+                            is_transparent, accumulate > );
         // ...
         // ..
         // @
-        cast_horizontal_zlight_segment < 1, 0, 0, -1, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 1, 0, 0, -1, 1, T, calc,
+                            is_transparent, accumulate > );
         // .
         // ..
         // ..@
-        cast_horizontal_zlight_segment < 0, -1, -1, 0, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < 0, -1, -1, 0, 1, T, calc,
+                            is_transparent, accumulate > );
         // ...
         //  ..
         //   @
-        cast_horizontal_zlight_segment < -1, 0, 0, -1, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_horizontal_zlight_segment < -1, 0, 0, -1, 1, T, calc,
+                            is_transparent, accumulate > );
 
         // Straight up
         // @.
         // ..
-        cast_vertical_zlight_segment < 1, 1, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_vertical_zlight_segment < 1, 1, 1, T, calc,
+                            is_transparent, accumulate > );
         // ..
         // @.
-        cast_vertical_zlight_segment < 1, -1, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_vertical_zlight_segment < 1, -1, 1, T, calc,
+                            is_transparent, accumulate > );
         // .@
         // ..
-        cast_vertical_zlight_segment < -1, 1, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_vertical_zlight_segment < -1, 1, 1, T, calc,
+                            is_transparent, accumulate > );
         // ..
         // .@
-        cast_vertical_zlight_segment < -1, -1, 1, T, calc, is_transparent, accumulate > (
-            output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+        segments.push_back( cast_vertical_zlight_segment < -1, -1, 1, T, calc,
+                            is_transparent, accumulate > );
     }
-}
 
+    if constexpr( std::is_same_v<T, float> ) {
+        const int num_threads = shadowcasting_threads( static_cast<int>( segments.size() ) );
+        if( num_threads > 1 ) {
+            // Every thread but this one casts into its own copy of the output, merged in
+            // afterwards. Casting only ever raises output to the max of what it holds and the new
+            // value, so that gives exactly the same result as casting everything in order.
+            // Fragment clouds that compare equal can still differ, so they're always cast in order.
+            // The copies are big, so they're kept for the next call.
+            using grids = std::array<cata::mdarray<T, point_bub_ms>, OVERMAP_LAYERS>;
+            thread_local std::vector<std::unique_ptr<grids>> thread_grids;
+            if( static_cast<int>( thread_grids.size() ) < num_threads ) {
+                thread_grids.resize( num_threads );
+            }
+            std::vector<array_of_grids_of<T>> thread_outputs( num_threads, output_caches );
+            for( int i = 1; i < num_threads; ++i ) {
+                if( !thread_grids[i] ) {
+                    thread_grids[i] = std::make_unique<grids>();
+                }
+                for( int z = 0; z < OVERMAP_LAYERS; ++z ) {
+                    if( output_caches[z] != nullptr ) {
+                        ( *thread_grids[i] )[z].fill( std::numeric_limits<T>::lowest() );
+                        thread_outputs[i][z] = &( *thread_grids[i] )[z];
+                    }
+                }
+            }
+            run_shadowcasting_jobs( num_threads, [&]( int thread ) {
+                for( size_t i = thread; i < segments.size(); i += num_threads ) {
+                    segments[i]( thread_outputs[thread], input_arrays, floor_caches, origin,
+                                 offset_distance, numerator );
+                }
+            } );
+            for( int i = 1; i < num_threads; ++i ) {
+                for( int z = 0; z < OVERMAP_LAYERS; ++z ) {
+                    if( output_caches[z] != nullptr ) {
+                        merge_max( *output_caches[z], *thread_outputs[i][z] );
+                    }
+                }
+            }
+            return;
+        }
+    }
+
+    for( segment_function segment : segments ) {
+        segment( output_caches, input_arrays, floor_caches, origin, offset_distance, numerator );
+    }
+}
 // I can't figure out how to make implicit instantiation work when the parameters of
 // the template-supplied function pointers are involved, so I'm explicitly instantiating instead.
 template void cast_zlight<float, sight_calc, sight_check, accumulate_transparency>(
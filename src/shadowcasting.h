@@ -115,6 +115,34 @@ inline float accumulate_transparency( const float &cumulative_transparency,
     return ( ( distance - 1 ) * cumulative_transparency + current_transparency ) / distance;
 }
 
+// How many threads to spread this many independent pieces of shadowcasting over, counting the
+// calling one. Never more than the SHADOWCASTING_THREADS option allows.
+int shadowcasting_threads( int jobs );
+// Call job( i ) for every i below num_threads, each on a thread of its own, job( 0 ) on the
+// calling one. Returns once all of them are done. The threads are kept around between calls.
+void run_shadowcasting_jobs( int num_threads, const std::function<void( int )> &job );
+
+// Raise every value in into to at least the matching one in from. That's how the results of
+// casting on several threads get combined.
+inline void merge_max( cata::mdarray<float, point_bub_ms> &into,
+                       const cata::mdarray<float, point_bub_ms> &from )
+{
+    float *out = &into[0][0];
+    const float *in = &from[0][0];
+    for( int i = 0; i < MAPSIZE_X * MAPSIZE_Y; ++i ) {
+        out[i] = std::max( out[i], in[i] );
+    }
+}
+inline void merge_max( cata::mdarray<four_quadrants, point_bub_ms> &into,
+                       const cata::mdarray<four_quadrants, point_bub_ms> &from )
+{
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            into[x][y] = elementwise_max( into[x][y], from[x][y] );
+        }
+    }
+}
+
 template<typename T, typename Out, T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
          void( *update_output )( Out &, const T &, quadrant ),
@@ -41,6 +41,21 @@ void submap::clear_fields( const point_sm_ms &p )
     f.clear();
 }
 
+void submap::index_field_tiles()
+{
+    field_tiles.reset();
+    if( is_uniform() ) {
+        return;
+    }
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            if( m->fld[x][y].field_count() > 0 ) {
+                field_tiles.set( field_tile_index( { x, y } ) );
+            }
+        }
+    }
+}
+
 static const std::string COSMETICS_GRAFFITI( "GRAFFITI" );
 static const std::string COSMETICS_SIGNAGE( "SIGNAGE" );
 // Handle GCC warning: 'warning: returning reference to temporary'
@@ -273,6 +288,8 @@ void submap::rotate( int turns )
         rot_comp.emplace( rotate_point( elem.first ), elem.second );
     }
     computers = rot_comp;
+
+    index_field_tiles();
 }
 
 void submap::mirror( bool horizontally )
@@ -317,6 +334,8 @@ void submap::mirror( bool horizontally )
         }
         computers = mirror_comp;
     }
+
+    index_field_tiles();
 }
 
 void submap::revert_submap( submap &sr )
@@ -384,6 +403,7 @@ void submap::update_lum_rem( const point_sm_ms &p, const item &i )
 void submap::merge_submaps( submap *copy_from, bool copy_from_is_overlay )
 {
     this->field_count = 0;
+    this->field_tiles.reset();
 
     for( int x = 0; x < SEEX; x++ ) {
         for( int y = 0; y < SEEY; y++ ) {
@@ -419,6 +439,7 @@ void submap::merge_submaps( submap *copy_from, bool copy_from_is_overlay )
             for( std::map<field_type_id, field_entry>::iterator it = this->m->fld[x][y].begin();
                  it != this->m->fld[x][y].end(); it++ ) {
                 this->field_count++;
+                this->field_tiles.set( field_tile_index( { x, y } ) );
             }
 
             if( copy_from->m->trp[x][y] != tr_null && ( copy_from_is_overlay ||
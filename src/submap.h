@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_SUBMAP_H
 #define CATA_SRC_SUBMAP_H
 
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
@@ -232,6 +233,13 @@ class submap
 
         void clear_fields( const point_sm_ms &p );
 
+        /** Index of @p p in field_tiles. */
+        static int field_tile_index( const point_sm_ms &p ) {
+            return p.x() * SEEY + p.y();
+        }
+        /** Rebuild field_tiles from scratch, after fields moved between tiles. */
+        void index_field_tiles();
+
         struct cosmetic_t {
             point_sm_ms pos;
             std::string type;
@@ -286,7 +294,17 @@ class submap
         void mirror( bool horizontally );
 
         void store( JsonOut &jsout ) const;
+        // Parts of store() for binary quad files (see quad_file.h), which keep terrain,
+        // furniture and items apart from the rest. store_items() writes the value of the
+        // "items" member, store_other() the members that are neither of those three.
+        void store_items( JsonOut &jsout ) const;
+        void store_other( JsonOut &jsout ) const;
         void load( const JsonValue &jv, const std::string &member_name, int version );
+        // Set terrain / furniture from a list of ids and, for each tile in row order, the
+        // index of its id in that list. Ids go through the same migrations as in load().
+        // An empty furniture id leaves the tile alone. @p tiles must have SEEX * SEEY valid indices.
+        void load_terrain( const std::vector<std::string> &ids, const std::vector<uint16_t> &tiles );
+        void load_furniture( const std::vector<std::string> &ids, const std::vector<uint16_t> &tiles );
 
         // If is_uniform is true, this submap is a solid block of terrain
         // Uniform submaps aren't saved/loaded, because regenerating them is faster
@@ -308,6 +326,12 @@ class submap
         active_item_cache active_items;
 
         int field_count = 0;
+        /**
+         * The tiles that hold fields, by field_tile_index(), so processing fields only has to
+         * visit those. It may still hold tiles whose fields have since been removed, they're
+         * dropped the next time fields get processed.
+         */
+        std::bitset<SEEX *SEEY> field_tiles; // NOLINT(cata-serialize)
         time_point last_touched = calendar::turn_zero;
         bool reverted = false; // NOLINT(cata-serialize)
         std::vector<spawn_point> spawns;
@@ -325,6 +349,11 @@ class submap
         };
 
     private:
+        // The members store() writes around terrain, furniture and items, in its order
+        void store_header( JsonOut &jsout ) const;
+        void store_radiation( JsonOut &jsout ) const;
+        void store_trailing( JsonOut &jsout ) const;
+
         std::map<point_sm_ms, tile_data> ephemeral_data;
         std::map<point_sm_ms, computer> computers;
         std::unique_ptr<maptile_soa> m;
@@ -0,0 +1,75 @@
+#include "benchmark_helpers.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "cata_catch.h"
+
+static std::atomic<long long> allocations( 0 );
+
+// Replaces the global allocation functions of the test binary, just to count the calls
+void *operator new( std::size_t size )
+{
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    if( void *ptr = std::malloc( size == 0 ? 1 : size ) ) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[]( std::size_t size )
+{
+    return operator new( size );
+}
+
+void operator delete( void *ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete[]( void *ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete( void *ptr, std::size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete[]( void *ptr, std::size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+long long allocation_count()
+{
+    return allocations.load( std::memory_order_relaxed );
+}
+
+void report_benchmark( const std::string &name, const std::string &units, int repeats,
+                       const std::function<long long()> &run )
+{
+    long long done = 0;
+    const long long allocations_before = allocation_count();
+    const std::chrono::high_resolution_clock::time_point start =
+        std::chrono::high_resolution_clock::now();
+    for( int i = 0; i < repeats; ++i ) {
+        done += run();
+    }
+    const std::chrono::high_resolution_clock::time_point end =
+        std::chrono::high_resolution_clock::now();
+    const long long allocated = allocation_count() - allocations_before;
+    const long long diff =
+        std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+    const double per_second = diff > 0 ? 1e6 * done / diff : 0.0;
+    printf( "%s: %lld %s in %lld microseconds, %.1f per second, %lld allocations.\n",
+            name.c_str(), done, units.c_str(), diff, per_second, allocated );
+
+    BENCHMARK( std::string( name ) ) {
+        return run();
+    };
+}
@@ -0,0 +1,20 @@
+#pragma once
+#ifndef CATA_TESTS_BENCHMARK_HELPERS_H
+#define CATA_TESTS_BENCHMARK_HELPERS_H
+
+#include <functional>
+#include <string>
+
+/** How many times the test binary has allocated memory through operator new so far. */
+long long allocation_count();
+
+/**
+ * Runs @p run @p repeats times and prints how long that took and how often it allocated, along
+ * with the sum of what it returned in @p units, so results can be compared between builds at a
+ * glance. Then hands
+ * @p run to Catch as a benchmark called @p name, for the detailed statistics.
+ */
+void report_benchmark( const std::string &name, const std::string &units, int repeats,
+                       const std::function<long long()> &run );
+
+#endif // CATA_TESTS_BENCHMARK_HELPERS_H
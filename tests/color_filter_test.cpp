@@ -0,0 +1,105 @@
+#if defined(TILES)
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cata_catch.h"
+#include "sdl_utils.h"
+
+static const std::vector<std::string> color_filter_names = {
+    "color_pixel_darken", "color_pixel_sepia_light", "color_pixel_sepia_dark",
+    "color_pixel_blue_dark", "color_pixel_custom", "color_pixel_grayscale",
+    "color_pixel_nightvision", "color_pixel_overexposed"
+};
+
+// Something resembling a tileset atlas: mostly transparent, with some black outlines.
+static std::vector<SDL_Color> make_pixels( size_t count )
+{
+    std::mt19937 gen( 42 );
+    std::uniform_int_distribution<int> byte( 0, 0xFF );
+    std::vector<SDL_Color> pixels( count );
+    for( size_t i = 0; i < count; ++i ) {
+        const int kind = byte( gen );
+        if( kind < 160 ) {
+            pixels[i] = { static_cast<Uint8>( byte( gen ) ), 0, 0, 0 };
+        } else if( kind < 176 ) {
+            pixels[i] = { 0, 0, 0, static_cast<Uint8>( byte( gen ) ) };
+        } else {
+            pixels[i] = { static_cast<Uint8>( byte( gen ) ), static_cast<Uint8>( byte( gen ) ),
+                          static_cast<Uint8>( byte( gen ) ), static_cast<Uint8>( byte( gen ) )
+                        };
+        }
+    }
+    return pixels;
+}
+
+static void filter_each_pixel( std::vector<SDL_Color> &pixels, color_pixel_function_pointer filter )
+{
+    for( SDL_Color &pix : pixels ) {
+        if( pix.a != 0x00 ) {
+            pix = filter( pix );
+        }
+    }
+}
+
+TEST_CASE( "color_filter_kernels_match_per_pixel_filters", "[tiles][color]" )
+{
+    // Odd size, so the vectorized kernels also go through their remainder
+    const std::vector<SDL_Color> pixels = make_pixels( 100003 );
+    for( const std::string &name : color_filter_names ) {
+        CAPTURE( name );
+        const color_pixel_function_pointer filter = get_color_pixel_function( name );
+        REQUIRE( filter != nullptr );
+        std::vector<SDL_Color> expected = pixels;
+        filter_each_pixel( expected, filter );
+        std::vector<SDL_Color> actual = pixels;
+        apply_color_filter( actual.data(), actual.size(), filter );
+        CHECK( std::memcmp( expected.data(), actual.data(), pixels.size() * sizeof( SDL_Color ) ) == 0 );
+    }
+}
+
+TEST_CASE( "color_filter_benchmark", "[.][tiles][color][benchmark]" )
+{
+    // Roughly the size of a large tileset atlas
+    const std::vector<SDL_Color> pixels = make_pixels( 4096 * 4096 );
+    for( const std::string &name : color_filter_names ) {
+        const color_pixel_function_pointer filter = get_color_pixel_function( name );
+        const auto time = [&]( const auto & apply ) {
+            std::vector<SDL_Color> copy = pixels;
+            const std::chrono::high_resolution_clock::time_point start =
+                std::chrono::high_resolution_clock::now();
+            apply( copy );
+            const std::chrono::high_resolution_clock::time_point end =
+                std::chrono::high_resolution_clock::now();
+            return std::chrono::duration_cast<std::chrono::microseconds>( end - start ).count();
+        };
+        const long long per_pixel = time( [&]( std::vector<SDL_Color> &p ) {
+            filter_each_pixel( p, filter );
+        } );
+        const long long kernel = time( [&]( std::vector<SDL_Color> &p ) {
+            apply_color_filter( p.data(), p.size(), filter );
+        } );
+        printf( "%s: %lld microseconds calling the filter per pixel, %lld with the kernel.\n",
+                name.c_str(), per_pixel, kernel );
+    }
+
+    std::vector<SDL_Color> copy = pixels;
+    BENCHMARK( "grayscale" ) {
+        apply_color_filter( copy.data(), copy.size(), color_pixel_grayscale );
+    };
+    BENCHMARK( "nightvision" ) {
+        apply_color_filter( copy.data(), copy.size(), color_pixel_nightvision );
+    };
+    BENCHMARK( "sepia_light" ) {
+        apply_color_filter( copy.data(), copy.size(), color_pixel_sepia_light );
+    };
+    BENCHMARK( "custom" ) {
+        apply_color_filter( copy.data(), copy.size(), color_pixel_custom );
+    };
+}
+
+#endif // TILES
@@ -0,0 +1,150 @@
+#include <cstdlib>
+#include <vector>
+
+#include "avatar.h"
+#include "benchmark_helpers.h"
+#include "cata_catch.h"
+#include "coordinates.h"
+#include "creature_tracker.h"
+#include "game.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "map_scale_constants.h"
+#include "memory_fast.h"
+#include "monster.h"
+#include "player_helpers.h"
+#include "point.h"
+
+// Zombies scattered all over the reality bubble, every @p spacing tiles
+static void spawn_horde( int spacing )
+{
+    const tripoint_bub_ms avatar_pos = get_avatar().pos_bub();
+    for( int x = 1; x < MAPSIZE_X - 1; x += spacing ) {
+        for( int y = 1; y < MAPSIZE_Y - 1; y += spacing ) {
+            const tripoint_bub_ms p( x, y, 0 );
+            if( p != avatar_pos ) {
+                spawn_test_monster( "mon_zombie", p );
+            }
+        }
+    }
+}
+
+// What monsters_around() should find, the slow way
+static std::vector<monster *> monsters_around_slowly( const tripoint_abs_ms &center, int radius )
+{
+    std::vector<monster *> ret;
+    for( monster &critter : g->all_monsters() ) {
+        const tripoint_abs_ms pos = critter.pos_abs();
+        if( pos.z() == center.z() && std::abs( pos.x() - center.x() ) <= radius &&
+            std::abs( pos.y() - center.y() ) <= radius ) {
+            ret.push_back( &critter );
+        }
+    }
+    return ret;
+}
+
+static void check_monsters_around()
+{
+    const map &here = get_map();
+    creature_tracker &tracker = get_creature_tracker();
+    for( int x = 0; x < MAPSIZE_X; x += 7 ) {
+        for( int y = 0; y < MAPSIZE_Y; y += 7 ) {
+            for( int radius : {
+                     0, 5, 30
+                 } ) {
+                const tripoint_abs_ms center = here.get_abs( tripoint_bub_ms( x, y, 0 ) );
+                CAPTURE( center, radius );
+                // Both in list order, mattack::upgrade picks from them at random
+                CHECK( tracker.monsters_around( center, radius ) ==
+                       monsters_around_slowly( center, radius ) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "creature_tracker_finds_the_monsters_around_a_point", "[creature_tracker]" )
+{
+    clear_map();
+    clear_avatar();
+    spawn_horde( 9 );
+    map &here = get_map();
+    creature_tracker &tracker = get_creature_tracker();
+    REQUIRE( tracker.size() > 100 );
+
+    SECTION( "where they were spawned" ) {
+        check_monsters_around();
+    }
+    SECTION( "after they moved to other submaps" ) {
+        for( monster &critter : g->all_monsters() ) {
+            const tripoint_bub_ms pos = critter.pos_bub();
+            const tripoint_bub_ms dest( pos.x() + 4, pos.y() + 3, 0 );
+            if( here.inbounds( dest ) && !tracker.creature_at( dest, true ) ) {
+                critter.setpos( here, dest );
+            }
+        }
+        check_monsters_around();
+    }
+    SECTION( "after some of them swapped places" ) {
+        const std::vector<shared_ptr_fast<monster>> &monsters = tracker.get_monsters_list();
+        for( size_t i = 0; i + 50 < monsters.size(); i += 3 ) {
+            tracker.swap_positions( *monsters[i], *monsters[i + 50] );
+        }
+        check_monsters_around();
+    }
+    SECTION( "after some of them died" ) {
+        for( monster &critter : g->all_monsters() ) {
+            if( critter.pos_bub().x() % 2 == 0 ) {
+                critter.die( &here, nullptr );
+            }
+        }
+        check_monsters_around();
+        g->cleanup_dead();
+        check_monsters_around();
+    }
+}
+
+// How many of the monsters are within @p radius of each other, the way target scans used to
+// look for them
+static int count_neighbours_in_all_monsters( int radius )
+{
+    int found = 0;
+    for( const monster &critter : g->all_monsters() ) {
+        const tripoint_abs_ms pos = critter.pos_abs();
+        for( const monster &other : g->all_monsters() ) {
+            found += rl_dist( pos, other.pos_abs() ) <= radius;
+        }
+    }
+    return found;
+}
+
+static int count_neighbours_around( int radius )
+{
+    const creature_tracker &tracker = get_creature_tracker();
+    int found = 0;
+    for( const monster &critter : g->all_monsters() ) {
+        const tripoint_abs_ms pos = critter.pos_abs();
+        for( const monster *other : tracker.monsters_around( pos, radius ) ) {
+            found += rl_dist( pos, other->pos_abs() ) <= radius;
+        }
+    }
+    return found;
+}
+
+TEST_CASE( "creature_tracker_horde_benchmark", "[.][creature_tracker][benchmark]" )
+{
+    clear_map();
+    clear_avatar();
+    spawn_horde( 3 );
+    const int radius = 10;
+
+    REQUIRE( count_neighbours_around( radius ) == count_neighbours_in_all_monsters( radius ) );
+    report_benchmark( "horde, scanning all monsters", "neighbours found", 1, [&]() {
+        return count_neighbours_in_all_monsters( radius );
+    } );
+    report_benchmark( "horde, scanning nearby submaps", "neighbours found", 1, [&]() {
+        return count_neighbours_around( radius );
+    } );
+
+    clear_creatures();
+}
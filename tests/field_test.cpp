@@ -1,4 +1,6 @@
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "avatar.h"
@@ -13,11 +15,13 @@
 #include "map.h"
 #include "map_helpers.h"
 #include "map_iterator.h"
+#include "mapbuffer.h"
 #include "mapdata.h"
 #include "options_helpers.h"
 #include "player_helpers.h"
 #include "point.h"
 #include "string_formatter.h"
+#include "submap.h"
 #include "type_id.h"
 #include "weather_type.h"
 
@@ -264,6 +268,52 @@ TEST_CASE( "fire_spreading", "[field][!mayfail]" )
     fields_test_cleanup();
 }
 
+static std::pair<submap *, point_sm_ms> submap_of( map &m, const tripoint_bub_ms &p )
+{
+    tripoint_abs_sm sm;
+    point_sm_ms l;
+    std::tie( sm, l ) = coords::project_remain<coords::sm>( m.get_abs( p ) );
+    submap *const ret = MAPBUFFER.lookup_submap( sm );
+    REQUIRE( ret != nullptr );
+    return { ret, l };
+}
+
+static bool field_tile_indexed( map &m, const tripoint_bub_ms &p )
+{
+    const auto [sm, l] = submap_of( m, p );
+    return sm->field_tiles[submap::field_tile_index( l )];
+}
+
+TEST_CASE( "field_tiles_follow_the_fields_of_a_submap", "[field]" )
+{
+    fields_test_setup();
+    map &m = get_map();
+    const tripoint_bub_ms acid{ 33, 33, 0 };
+    const tripoint_bub_ms test_field{ 36, 38, 0 };
+
+    CHECK_FALSE( field_tile_indexed( m, acid ) );
+    m.add_field( acid, field_fd_acid, 1 );
+    m.add_field( test_field, field_fd_test, 1 );
+    CHECK( field_tile_indexed( m, acid ) );
+    CHECK( field_tile_indexed( m, test_field ) );
+
+    m.remove_field( acid, field_fd_acid );
+    calendar::turn += 1_turns;
+    m.process_fields();
+    CHECK_FALSE( field_tile_indexed( m, acid ) );
+    CHECK( field_tile_indexed( m, test_field ) );
+
+    SECTION( "rotating the submap moves the fields along" ) {
+        const auto [sm, l] = submap_of( m, test_field );
+        sm->rotate( 1 );
+        const point_sm_ms rotated = l.rotate( 1, { SEEX, SEEY } );
+        CHECK( sm->field_tiles.count() == 1 );
+        CHECK( sm->field_tiles[submap::field_tile_index( rotated )] );
+    }
+
+    fields_test_cleanup();
+}
+
 // tests fd_fire_vent <-> fd_flame_burst cycle
 TEST_CASE( "fd_fire_and_fd_fire_vent_test", "[field]" )
 {
@@ -1,5 +1,7 @@
 #include <algorithm>
 #include <array>
+#include <bitset>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <list>
@@ -61,6 +63,13 @@ void test_serialization( const T &val, const std::string &s )
         jsout.write( val );
         CHECK( os.str() == s );
     }
+    {
+        INFO( "test_serialization_to_string" );
+        std::string out;
+        JsonOut jsout( out );
+        jsout.write( val );
+        CHECK( out == s );
+    }
     {
         INFO( "test_deserialization" );
         JsonValue jsin = json_loader::from_string( s );
@@ -981,3 +990,59 @@ TEST_CASE( "serialize_optional", "[json]" )
         test_serialization( v, "[1,2,3]" );
     }
 }
+
+TEST_CASE( "serialize_numbers", "[json]" )
+{
+    test_serialization( -42, "-42" );
+    test_serialization( static_cast<uint64_t>( 5000000000 ), "5000000000" );
+    test_serialization( static_cast<int64_t>( -5000000000 ), "-5000000000" );
+    test_serialization( static_cast<int8_t>( -3 ), "-3" );
+    test_serialization( 1.5f, "1.500000" );
+    test_serialization( -0.1, "-0.100000" );
+    test_serialization( 1e20, "100000000000000000000.000000" );
+    test_serialization( true, "true" );
+}
+
+static void write_everything( JsonOut &jsout )
+{
+    jsout.start_object();
+    jsout.member( "escaped", "quote\" backslash\\ slash/ \b\f\n\r\t \x01\x1f" );
+    jsout.member( "small", 0.25 );
+    jsout.member( "symbol", U'\u263A' );
+    jsout.member( "flags" );
+    jsout.write( std::bitset<12>( 1234 ) );
+    jsout.member( "wrapped" );
+    jsout.start_array( true );
+    jsout.write( 1 );
+    jsout.start_object();
+    jsout.member( "x", 2.0 );
+    jsout.null_member( "y" );
+    jsout.end_object();
+    jsout.start_array();
+    jsout.write( 3 );
+    jsout.write( 4 );
+    jsout.end_array();
+    jsout.end_array();
+    jsout.member( "map", std::map<std::string, int> { { "a", 1 }, { "b", 2 } } );
+    jsout.end_object();
+}
+
+TEST_CASE( "json_written_to_strings_and_streams_is_the_same", "[json]" )
+{
+    for( const bool pretty : {
+             false, true
+         } ) {
+        CAPTURE( pretty );
+        std::ostringstream os;
+        {
+            JsonOut jsout( os, pretty );
+            write_everything( jsout );
+        }
+        std::string out = "prefix ";
+        {
+            JsonOut jsout( out, pretty );
+            write_everything( jsout );
+        }
+        CHECK( out == "prefix " + os.str() );
+    }
+}
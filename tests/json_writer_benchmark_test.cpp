@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark_helpers.h"
+#include "cata_catch.h"
+#include "cata_path.h"
+#include "coordinates.h"
+#include "flexbuffer_json.h"
+#include "item.h"
+#include "json.h"
+#include "json_loader.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "map_scale_constants.h"
+#include "mapbuffer.h"
+#include "path_info.h"
+#include "point.h"
+#include "submap.h"
+#include "type_id.h"
+
+static const furn_str_id furn_f_chair( "f_chair" );
+
+static const itype_id itype_rock( "rock" );
+
+static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
+
+// Writes @p jv back out as it is
+static void copy_json( const JsonValue &jv, JsonOut &jsout )
+{
+    if( jv.test_object() ) {
+        JsonObject jo = jv.get_object();
+        jo.allow_omitted_members();
+        jsout.start_object();
+        for( const JsonMember &member : jo ) {
+            jsout.member( member.name() );
+            copy_json( member, jsout );
+        }
+        jsout.end_object();
+    } else if( jv.test_array() ) {
+        jsout.start_array();
+        for( JsonValue entry : jv.get_array() ) {
+            copy_json( entry, jsout );
+        }
+        jsout.end_array();
+    } else if( jv.test_string() ) {
+        jsout.write( jv.get_string() );
+    } else if( jv.test_bool() ) {
+        jsout.write_bool( jv.get_bool() );
+    } else if( jv.test_int() ) {
+        jsout.write( jv.get_int64() );
+    } else if( jv.test_float() ) {
+        jsout.write( jv.get_float() );
+    } else {
+        jsout.write_null();
+    }
+}
+
+// Every submap of the reality bubble on every z-level, with walls, furniture and items on the
+// ground level
+static std::vector<const submap *> fill_submaps()
+{
+    clear_map();
+    map &here = get_map();
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            const tripoint_bub_ms p( x, y, 0 );
+            if( ( x + y ) % 7 == 0 ) {
+                here.ter_set( p, ter_t_brick_wall );
+            } else if( x % 5 == 0 && y % 3 == 0 ) {
+                here.furn_set( p, furn_f_chair );
+            } else if( x % 4 == 0 && y % 4 == 0 ) {
+                here.add_item( p, item( itype_rock ) );
+            }
+        }
+    }
+    const tripoint_abs_sm corner = here.get_abs_sub();
+    std::vector<const submap *> ret;
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+        for( int y = 0; y < MAPSIZE; ++y ) {
+            for( int x = 0; x < MAPSIZE; ++x ) {
+                ret.push_back( MAPBUFFER.lookup_submap( tripoint_abs_sm( corner.x() + x, corner.y() + y,
+                                                        z ) ) );
+            }
+        }
+    }
+    REQUIRE( std::find( ret.begin(), ret.end(), nullptr ) == ret.end() );
+    return ret;
+}
+
+static void store_submaps( const std::vector<const submap *> &submaps, JsonOut &jsout )
+{
+    jsout.start_array();
+    for( const submap *sm : submaps ) {
+        jsout.start_object();
+        sm->store( jsout );
+        jsout.end_object();
+    }
+    jsout.end_array();
+}
+
+static std::string write_to_stream( const std::function<void( JsonOut & )> &write, bool pretty )
+{
+    std::ostringstream buffer;
+    JsonOut jsout( buffer, pretty );
+    write( jsout );
+    return buffer.str();
+}
+
+static std::string write_to_string( const std::function<void( JsonOut & )> &write, bool pretty )
+{
+    std::string buffer;
+    JsonOut jsout( buffer, pretty );
+    write( jsout );
+    return buffer;
+}
+
+// The editor isn't linked into the tests, so instead of a project this writes out a mapgen file
+// of the same kind, a large building with its palettes, the way an export does: pretty printed.
+TEST_CASE( "json_writer_mapgen_benchmark", "[.][json][benchmark]" )
+{
+    const JsonValue mapgen = json_loader::from_path( PATH_INFO::jsondir() / "mapgen" /
+                             "mansion.json" );
+    const auto write = [&]( JsonOut & jsout ) {
+        copy_json( mapgen, jsout );
+    };
+
+    REQUIRE( write_to_string( write, true ) == write_to_stream( write, true ) );
+    report_benchmark( "mapgen, to a stream", "bytes of json written", 10, [&]() {
+        return write_to_stream( write, true ).size();
+    } );
+    report_benchmark( "mapgen, to a string", "bytes of json written", 10, [&]() {
+        return write_to_string( write, true ).size();
+    } );
+}
+
+TEST_CASE( "json_writer_submaps_benchmark", "[.][json][benchmark]" )
+{
+    const std::vector<const submap *> submaps = fill_submaps();
+    const auto write = [&]( JsonOut & jsout ) {
+        store_submaps( submaps, jsout );
+    };
+
+    REQUIRE( write_to_string( write, false ) == write_to_stream( write, false ) );
+    report_benchmark( "submaps, to a stream", "bytes of json written", 10, [&]() {
+        return write_to_stream( write, false ).size();
+    } );
+    report_benchmark( "submaps, to a string", "bytes of json written", 10, [&]() {
+        return write_to_string( write, false ).size();
+    } );
+}
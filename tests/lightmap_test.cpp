@@ -0,0 +1,143 @@
+#include <vector>
+
+#include "benchmark_helpers.h"
+#include "calendar.h"
+#include "cata_catch.h"
+#include "coordinates.h"
+#include "field_type.h"
+#include "level_cache.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "map_scale_constants.h"
+#include "options_helpers.h"
+#include "player_helpers.h"
+#include "point.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
+static const ter_str_id ter_t_floor( "t_floor" );
+
+static constexpr int block_size = 33;
+
+// A city block on fire: rooms with doorways between them, burning wherever there's no wall
+static tripoint_bub_ms set_up_burning_block()
+{
+    clear_map();
+    clear_avatar();
+    set_time( calendar::turn_zero );
+    map &here = get_map();
+    const tripoint_bub_ms corner( SEEX * 3, SEEY * 3, 0 );
+    for( int x = 0; x < block_size; ++x ) {
+        for( int y = 0; y < block_size; ++y ) {
+            const tripoint_bub_ms p = corner + point( x, y );
+            const bool wall = ( x % 8 == 0 || y % 8 == 0 ) && x % 8 != 4 && y % 8 != 4;
+            if( wall ) {
+                here.ter_set( p, ter_t_brick_wall );
+            } else {
+                here.ter_set( p, ter_t_floor );
+                here.add_field( p, fd_fire, 1 + ( x + y ) % 3 );
+            }
+        }
+    }
+    here.build_map_cache( 0 );
+    return corner;
+}
+
+// Everything the lightmap of the level holds, to compare
+static std::vector<float> lightmap_of( const map &here, int zlev )
+{
+    const level_cache &cache = here.get_cache_ref( zlev );
+    std::vector<float> ret;
+    ret.reserve( MAPSIZE_X * MAPSIZE_Y * 5 );
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            for( float value : cache.lm[x][y].values ) {
+                ret.push_back( value );
+            }
+            ret.push_back( cache.sm[x][y] );
+        }
+    }
+    return ret;
+}
+
+static void check_against_full_lightmap( map &here )
+{
+    here.build_map_cache( 0 );
+    const std::vector<float> incremental = lightmap_of( here, 0 );
+    here.clear_bulk_light( 0 );
+    here.build_map_cache( 0 );
+    CHECK( incremental == lightmap_of( here, 0 ) );
+}
+
+TEST_CASE( "incremental_lightmap_matches_full_regeneration", "[light][lightmap]" )
+{
+    map &here = get_map();
+    const tripoint_bub_ms corner = set_up_burning_block();
+
+    SECTION( "nothing changed" ) {
+        check_against_full_lightmap( here );
+    }
+    SECTION( "a fire went out" ) {
+        here.remove_field( corner + point( 10, 10 ), fd_fire );
+        check_against_full_lightmap( here );
+    }
+    SECTION( "a fire grew" ) {
+        here.add_field( corner + point( 12, 2 ), fd_fire, 3 );
+        check_against_full_lightmap( here );
+    }
+    SECTION( "a fire started outside of the block" ) {
+        here.add_field( corner + point( -6, 5 ), fd_fire, 3 );
+        check_against_full_lightmap( here );
+    }
+    SECTION( "a wall was knocked down" ) {
+        here.ter_set( corner + point( 8, 10 ), ter_t_floor );
+        check_against_full_lightmap( here );
+    }
+    SECTION( "a doorway was walled up" ) {
+        here.ter_set( corner + point( 8, 12 ), ter_t_brick_wall );
+        check_against_full_lightmap( here );
+    }
+    SECTION( "the whole block burnt out" ) {
+        clear_fields( 0 );
+        check_against_full_lightmap( here );
+    }
+    SECTION( "cast on one thread and on several" ) {
+        std::vector<float> one_thread;
+        {
+            override_option threads( "SHADOWCASTING_THREADS", "1" );
+            here.clear_bulk_light( 0 );
+            here.build_map_cache( 0 );
+            one_thread = lightmap_of( here, 0 );
+        }
+        override_option threads( "SHADOWCASTING_THREADS", "4" );
+        here.clear_bulk_light( 0 );
+        here.build_map_cache( 0 );
+        CHECK( one_thread == lightmap_of( here, 0 ) );
+    }
+}
+
+TEST_CASE( "lightmap_burning_block_benchmark", "[.][light][lightmap][benchmark]" )
+{
+    map &here = get_map();
+    const tripoint_bub_ms corner = set_up_burning_block();
+    const tripoint_bub_ms flickering = corner + point( 10, 10 );
+
+    report_benchmark( "burning block, nothing changed", "map caches built", 100, [&]() {
+        here.build_map_cache( 0 );
+        return 1;
+    } );
+    report_benchmark( "burning block, cast from scratch", "map caches built", 100, [&]() {
+        here.clear_bulk_light( 0 );
+        here.build_map_cache( 0 );
+        return 1;
+    } );
+    report_benchmark( "burning block, one fire flickering", "map caches built", 100, [&]() {
+        if( here.get_field( flickering, fd_fire ) ) {
+            here.remove_field( flickering, fd_fire );
+        } else {
+            here.add_field( flickering, fd_fire, 3 );
+        }
+        here.build_map_cache( 0 );
+        return 1;
+    } );
+}
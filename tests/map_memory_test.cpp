@@ -9,6 +9,7 @@
 #include "map.h"
 #include "map_memory.h"
 #include "map_scale_constants.h"
+#include "options_helpers.h"
 #include "point.h"
 
 static constexpr tripoint_abs_ms p1{ -SEEX - 2, -SEEY - 3, -1 };
@@ -122,6 +123,63 @@ TEST_CASE( "map_memory_forgets", "[map_memory]" )
     CHECK( mt.get_dec_rotation() == 0 );
 }
 
+// A single tile in the middle of the @p i th region along the x axis, spaced so that each one
+// gets prepared in regions of its own
+static tripoint_abs_ms region_center( int i )
+{
+    return tripoint_abs_ms( ( i * 2 * MM_REG_SIZE + MM_REG_SIZE / 2 ) * SEEX,
+                            MM_REG_SIZE / 2 * SEEY, -1 );
+}
+
+TEST_CASE( "map_memory_evicts_least_recently_used_regions", "[map_memory]" )
+{
+    override_option resident( "MAP_MEMORY_RESIDENT_MB", "16" );
+    const size_t limit = map_memory::max_resident_bytes();
+    map_memory memory;
+    memory.prepare_region( region_center( 0 ), region_center( 0 ) );
+    memory.set_tile_symbol( region_center( 0 ), 1 );
+
+    // Until the region memorized first, the least recently used one, gets evicted
+    int visited = 1;
+    for( ; memory.get_stats().serialized == 0 && visited < 1000; visited++ ) {
+        REQUIRE( memory.prepare_region( region_center( visited ), region_center( visited ) ) );
+        CHECK( memory.get_stats().resident_bytes <= limit );
+    }
+    const map_memory_stats evicted = memory.get_stats();
+    REQUIRE( evicted.serialized == 1 );
+    // It waits in memory for the next save instead of going to disk early
+    CHECK( evicted.pending == 1 );
+    REQUIRE( visited > 2 );
+    memory.set_tile_symbol( region_center( visited - 1 ), 2 );
+
+    // Going back a bit, all of it is still in memory
+    const tripoint_abs_ms recent = region_center( visited - 2 );
+    CHECK( memory.prepare_region( recent, recent ) );
+    CHECK( memory.prepare_region( region_center( visited - 1 ), region_center( visited - 1 ) ) );
+    CHECK( memory.get_tile( region_center( visited - 1 ) ).symbol == 2 );
+    const map_memory_stats back = memory.get_stats();
+    CHECK( back.hits > evicted.hits );
+    CHECK( back.loads + back.allocations == evicted.loads + evicted.allocations );
+
+    // Going all the way back, it has to be brought back in
+    CHECK( memory.prepare_region( region_center( 0 ), region_center( 0 ) ) );
+    const map_memory_stats start = memory.get_stats();
+    CHECK( start.loads + start.allocations > back.loads + back.allocations );
+    CHECK( start.resident_bytes <= limit );
+    CHECK( memory.get_tile( region_center( 0 ) ).symbol == 1 );
+}
+
+TEST_CASE( "map_memory_counts_decorations_towards_resident_size", "[map_memory]" )
+{
+    map_memory memory;
+    memory.prepare_region( region_center( 0 ), region_center( 0 ) );
+    memory.set_tile_symbol( region_center( 0 ), 1 );
+    const size_t plain = memory.get_stats().resident_bytes;
+    const std::string long_id( 200, 'x' );
+    memory.set_tile_decoration( region_center( 0 ), long_id, 0, 0 );
+    CHECK( memory.get_stats().resident_bytes >= plain + long_id.size() );
+}
+
 // TODO: map memory save / load
 
 #include <chrono>
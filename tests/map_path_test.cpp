@@ -647,3 +647,70 @@ TEST_CASE( "map_route_mon_around_danger", "[map][pathfinding]" )
     }
     clear_map();
 }
+
+TEST_CASE( "map_route_shared_by_a_crowd", "[map][pathfinding]" )
+{
+    map &m = setup_map_without_obstacles();
+    const Character &pc = place_player_at( tripoint_bub_ms{ 65, 65, 0 } );
+    /*
+     * Map layout:
+     * # # # # # # . . .
+     * . . . . . # . # .    #=obstacle
+     * . . . # . # . # .    @=player
+     * . . @ # . . . # 1    1=target
+     * # # # # # # # # .
+     */
+    place_obstacle( m, {
+        { 63, 62, 0 }, { 63, 66, 0 },
+        { 64, 62, 0 }, { 64, 66, 0 },
+        { 65, 62, 0 }, { 65, 66, 0 },
+        { 66, 62, 0 }, { 66, 64, 0 }, { 66, 65, 0 }, { 66, 66, 0 },
+        { 67, 62, 0 }, { 67, 66, 0 },
+        { 68, 62, 0 }, { 68, 63, 0 }, { 68, 64, 0 }, { 68, 66, 0 },
+        { 69, 66, 0 },
+        { 70, 63, 0 }, { 70, 64, 0 }, { 70, 65, 0 }, { 70, 66, 0 },
+    } );
+    const pathfinding_target target = pathfinding_target::point( tripoint_bub_ms{ 71, 65, 0 } );
+    const std::vector<tripoint_bub_ms> expected = m.route( pc, target );
+    REQUIRE( expected.size() == 10 );
+
+    // Enough of a crowd that the later ones follow the shared costs
+    const auto route_crowd = [&]( const std::vector<tripoint_bub_ms> &cheapest ) {
+        for( int i = 0; i < 8; ++i ) {
+            CAPTURE( i );
+            const std::vector<tripoint_bub_ms> path = m.route_shared( pc, target );
+            REQUIRE( path.size() == cheapest.size() );
+            CHECK( path.back() == target.center );
+            tripoint_bub_ms prev = pc.pos_bub();
+            for( const tripoint_bub_ms &p : path ) {
+                CHECK( square_dist( prev, p ) == 1 );
+                CHECK( m.passable( p ) );
+                prev = p;
+            }
+        }
+    };
+    route_crowd( expected );
+
+    // Worked out once for the current state of the map, then reused by the rest of the crowd
+    const path_flow_field *field = m.find_path_flow_field( target, pc.get_pathfinding_settings() );
+    REQUIRE( field != nullptr );
+    CHECK( field->computed );
+    CHECK( field->builds == 1 );
+    CHECK( field->generation == m.get_pathfinding_generation( 0 ) );
+
+    SECTION( "the shared costs are worked out again once a tile changes" ) {
+        const tripoint_bub_ms blocked = expected[expected.size() / 2];
+        place_obstacle( m, { blocked } );
+        const std::vector<tripoint_bub_ms> rerouted = m.route( pc, target );
+        REQUIRE( !rerouted.empty() );
+        REQUIRE( std::find( rerouted.begin(), rerouted.end(), blocked ) == rerouted.end() );
+        route_crowd( rerouted );
+
+        field = m.find_path_flow_field( target, pc.get_pathfinding_settings() );
+        REQUIRE( field != nullptr );
+        CHECK( field->computed );
+        CHECK( field->builds == 2 );
+        CHECK( field->generation == m.get_pathfinding_generation( 0 ) );
+    }
+    clear_map();
+}
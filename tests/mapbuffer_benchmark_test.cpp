@@ -0,0 +1,81 @@
+#include <memory>
+
+#include "avatar.h"
+#include "benchmark_helpers.h"
+#include "cata_catch.h"
+#include "coordinates.h"
+#include "map_helpers.h"
+#include "map_scale_constants.h"
+#include "mapbuffer.h"
+#include "player_helpers.h"
+#include "point.h"
+#include "submap.h"
+
+// Submaps in each direction that get buffered for the benchmark
+static constexpr int buffered_extent = 256;
+
+// Far away from the reality bubble, so clear_outside_reality_bubble() throws it all away again
+static tripoint_abs_sm benchmark_origin()
+{
+    return project_to<coords::sm>( get_avatar().pos_abs() ) + tripoint( 100, 100, 0 );
+}
+
+static void fill_mapbuffer( const tripoint_abs_sm &origin )
+{
+    for( int y = 0; y < buffered_extent; ++y ) {
+        for( int x = 0; x < buffered_extent; ++x ) {
+            std::unique_ptr<submap> sm = std::make_unique<submap>();
+            MAPBUFFER.add_submap( origin + tripoint( x, y, 0 ), sm );
+        }
+    }
+}
+
+// Look up every submap of a reality bubble sized window, like map::loadn does after a shift
+static int lookup_window( const tripoint_abs_sm &corner )
+{
+    int found = 0;
+    for( int y = 0; y < MAPSIZE; ++y ) {
+        for( int x = 0; x < MAPSIZE; ++x ) {
+            found += MAPBUFFER.lookup_submap( corner + tripoint( x, y, 0 ) ) != nullptr;
+        }
+    }
+    return found;
+}
+
+// Shift the window back and forth by one submap, as when walking around
+static int shift_back_and_forth( const tripoint_abs_sm &origin )
+{
+    int found = 0;
+    for( int i = 0; i < 100; ++i ) {
+        found += lookup_window( origin + tripoint( 50 + i % 2, 50, 0 ) );
+    }
+    return found;
+}
+
+// Move the window diagonally across the whole buffered area, as when driving far
+static int travel_across( const tripoint_abs_sm &origin )
+{
+    int found = 0;
+    for( int i = 0; i + MAPSIZE < buffered_extent; ++i ) {
+        found += lookup_window( origin + tripoint( i, i, 0 ) );
+    }
+    return found;
+}
+
+TEST_CASE( "mapbuffer_lookup_benchmark", "[.][mapbuffer][benchmark]" )
+{
+    clear_map();
+    clear_avatar();
+    const tripoint_abs_sm origin = benchmark_origin();
+    fill_mapbuffer( origin );
+
+    REQUIRE( lookup_window( origin ) == MAPSIZE * MAPSIZE );
+    report_benchmark( "map shift", "submaps looked up", 1, [&]() {
+        return shift_back_and_forth( origin );
+    } );
+    report_benchmark( "long distance travel", "submaps looked up", 1, [&]() {
+        return travel_across( origin );
+    } );
+
+    MAPBUFFER.clear_outside_reality_bubble();
+}
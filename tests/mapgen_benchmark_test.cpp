@@ -0,0 +1,122 @@
+#include <array>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "avatar.h"
+#include "benchmark_helpers.h"
+#include "calendar.h"
+#include "cata_catch.h"
+#include "coordinates.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "map_scale_constants.h"
+#include "mapbuffer.h"
+#include "mapgen.h"
+#include "mapgen_helpers.h"
+#include "overmapbuffer.h"
+#include "player_helpers.h"
+#include "type_id.h"
+
+static const nested_mapgen_id nested_mapgen_lab_room_9x9( "lab_room_9x9" );
+
+static const oter_str_id oter_forest_thick( "forest_thick" );
+static const oter_str_id oter_hospital_1( "hospital_1" );
+static const oter_str_id oter_house_w_1( "house_w_1" );
+static const oter_str_id oter_lab_stairs( "lab_stairs" );
+static const oter_str_id oter_mall_a_1( "mall_a_1" );
+
+static const update_mapgen_id update_mapgen_mx_prison_bus( "mx_prison_bus" );
+
+// A generated omt column is 2x2 submaps on every z-level
+static constexpr int submaps_per_omt = 4 * OVERMAP_LAYERS;
+// lab_room_9x9 is nested into a 9x9 area
+static constexpr int tiles_per_nest = 9 * 9;
+// mx_prison_bus updates a single omt
+static constexpr int tiles_per_update = 2 * SEEX * 2 * SEEY;
+
+// Somewhere far away from the reality bubble, so generation isn't merged into the main map
+static tripoint_abs_omt benchmark_omt()
+{
+    return project_to<coords::omt>( get_avatar().pos_abs() ) + tripoint( 10, 10, 0 );
+}
+
+// In the order of mapgen_phase
+static const std::array<const char *, static_cast<size_t>( mapgen_phase::last )> phase_names = {
+    "removal", "terrain", "furniture", "default", "nested_mapgen", "transform",
+    "faction_ownership", "zones"
+};
+
+// Runs @p generate @p repeats times and prints how long each mapgen phase took per run
+static void report_phases( const std::string &name, int repeats,
+                           const std::function<void()> &generate )
+{
+    mapgen_phase_timings &timings = get_mapgen_phase_timings();
+    timings = mapgen_phase_timings();
+    timings.enabled = true;
+    for( int i = 0; i < repeats; ++i ) {
+        generate();
+    }
+    timings.enabled = false;
+    printf( "%s phases, microseconds per run:", name.c_str() );
+    for( size_t phase = 0; phase < phase_names.size(); ++phase ) {
+        printf( " %s %.1f", phase_names[phase], timings.nanoseconds[phase] / 1e3 / repeats );
+    }
+    printf( "\n" );
+}
+
+static void generate_oter( const tripoint_abs_omt &pos, const oter_str_id &oter )
+{
+    overmap_buffer.ter_set( pos, oter.id() );
+    // Throw away the previous result so every iteration generates from scratch
+    MAPBUFFER.clear_outside_reality_bubble();
+    smallmap tm;
+    tm.generate( pos, calendar::turn, false );
+    tm.delete_unmerged_submaps();
+}
+
+TEST_CASE( "mapgen_oter_benchmark", "[.][mapgen][benchmark]" )
+{
+    clear_map();
+    clear_avatar();
+    const tripoint_abs_omt pos = benchmark_omt();
+
+    const std::vector<oter_str_id> oters = {
+        oter_house_w_1, oter_hospital_1, oter_mall_a_1, oter_lab_stairs, oter_forest_thick
+    };
+    for( const oter_str_id &oter : oters ) {
+        REQUIRE( oter.is_valid() );
+        report_benchmark( oter.str(), "submaps generated", 50, [&]() {
+            generate_oter( pos, oter );
+            return submaps_per_omt;
+        } );
+        report_phases( oter.str(), 50, [&]() {
+            generate_oter( pos, oter );
+        } );
+    }
+    overmap_buffer.reset();
+}
+
+TEST_CASE( "mapgen_nested_and_update_benchmark", "[.][mapgen][benchmark]" )
+{
+    clear_map();
+    clear_avatar();
+    const tripoint_abs_omt pos = benchmark_omt();
+
+    report_benchmark( "nested " + nested_mapgen_lab_room_9x9.str(), "tiles nested", 200, [&]() {
+        manual_nested_mapgen( pos, nested_mapgen_lab_room_9x9 );
+        return tiles_per_nest;
+    } );
+    report_phases( "nested " + nested_mapgen_lab_room_9x9.str(), 200, [&]() {
+        manual_nested_mapgen( pos, nested_mapgen_lab_room_9x9 );
+    } );
+    report_benchmark( "update " + update_mapgen_mx_prison_bus.str(), "tiles updated", 200, [&]() {
+        manual_update_mapgen( pos, update_mapgen_mx_prison_bus );
+        return tiles_per_update;
+    } );
+    report_phases( "update " + update_mapgen_mx_prison_bus.str(), 200, [&]() {
+        manual_update_mapgen( pos, update_mapgen_mx_prison_bus );
+    } );
+    overmap_buffer.reset();
+}
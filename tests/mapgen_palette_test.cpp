@@ -0,0 +1,66 @@
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cata_catch.h"
+#include "mapgen.h"
+#include "mapgen_map_key.h"
+#include "mapgen_parameter.h"
+#include "memory_fast.h"
+#include "type_id.h"
+
+// The piece that ends up being placed, and what it is constrained to
+static std::pair<const jmapgen_piece *, std::vector<std::pair<std::string, std::string>>>
+        unwrap( const shared_ptr_fast<const jmapgen_piece> &piece )
+{
+    if( piece->is_constrained() ) {
+        return { piece->get_constrained_inner(), piece->get_constraints() };
+    }
+    return { piece.get(), {} };
+}
+
+TEST_CASE( "flattened_palettes_resolve_like_merging_them", "[mapgen][palette]" )
+{
+    int constrained = 0;
+    for( const std::pair<const palette_id, mapgen_palette> &it : mapgen_palette::get_all() ) {
+        CAPTURE( it.first.str() );
+        const shared_ptr_fast<const mapgen_palette> merged_ptr =
+            mapgen_palette::resolve( it.first, false );
+        const shared_ptr_fast<const mapgen_palette> flattened_ptr =
+            mapgen_palette::resolve( it.first, true );
+        const mapgen_palette &merged = *merged_ptr;
+        const mapgen_palette &flattened = *flattened_ptr;
+
+        CHECK( flattened.keys_with_terrain == merged.keys_with_terrain );
+        std::vector<std::string> merged_parameters;
+        for( const std::pair<const std::string, mapgen_parameter> &param :
+             merged.get_parameters().map ) {
+            merged_parameters.push_back( param.first );
+        }
+        std::vector<std::string> flattened_parameters;
+        for( const std::pair<const std::string, mapgen_parameter> &param :
+             flattened.get_parameters().map ) {
+            flattened_parameters.push_back( param.first );
+        }
+        CHECK( flattened_parameters == merged_parameters );
+
+        REQUIRE( flattened.format_placings.size() == merged.format_placings.size() );
+        for( const auto &placing : merged.format_placings ) {
+            CAPTURE( placing.first.str );
+            const auto flat_it = flattened.format_placings.find( placing.first );
+            REQUIRE( flat_it != flattened.format_placings.end() );
+            REQUIRE( flat_it->second.size() == placing.second.size() );
+            for( size_t i = 0; i < placing.second.size(); ++i ) {
+                const auto expected = unwrap( placing.second[i] );
+                CHECK( unwrap( flat_it->second[i] ) == expected );
+                if( !expected.second.empty() ) {
+                    constrained++;
+                }
+            }
+        }
+    }
+    // Palettes choosing between other palettes by parameter were compared too
+    CHECK( constrained > 0 );
+}
@@ -1,14 +1,22 @@
+#include <algorithm>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "benchmark_helpers.h"
 #include "calendar.h"
 #include "cata_catch.h"
 #include "coordinates.h"
+#include "do_turn.h"
 #include "map.h"
 #include "map_helpers.h"
+#include "map_scale_constants.h"
 #include "monster.h"
+#include "options_helpers.h"
 #include "point.h"
 #include "type_id.h"
 
+static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
 static const ter_str_id ter_t_floor( "t_floor" );
 
 static monster &spawn_and_clear( const tripoint_bub_ms &pos, bool set_floor )
@@ -74,3 +82,126 @@ TEST_CASE( "monsters_should_not_see_through_floors", "[vision]" )
     CHECK( sky.sees( here, distant ) );
     CHECK( distant.sees( here, sky ) );
 }
+
+// Pillars scattered around, so some of the lines are blocked and some are not
+static void set_pillars( bool standing )
+{
+    map &here = get_map();
+    for( int x = 20; x < 100; x += 3 ) {
+        for( int y = 20; y < 100; y += 4 ) {
+            if( ( x * 7 + y * 3 ) % 5 < 2 ) {
+                here.ter_set( tripoint_bub_ms( x, y, 0 ), standing ? ter_t_brick_wall : ter_t_floor );
+            }
+        }
+    }
+    here.build_map_cache( 0 );
+}
+
+static std::vector<bool> lines_seen( const std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>>
+                                     &lines )
+{
+    const map &here = get_map();
+    std::vector<bool> ret;
+    for( const std::pair<tripoint_bub_ms, tripoint_bub_ms> &line : lines ) {
+        ret.push_back( here.sees( line.first, line.second, MAX_VIEW_DISTANCE ) );
+    }
+    return ret;
+}
+
+TEST_CASE( "sight_lines_cast_ahead_match_those_cast_on_demand", "[vision]" )
+{
+    clear_map();
+    map &here = get_map();
+    override_option threads( "SHADOWCASTING_THREADS", "4" );
+
+    std::vector<tripoint_bub_ms> watchers;
+    for( int x = 25; x < 95; x += 10 ) {
+        for( int y = 22; y < 98; y += 9 ) {
+            watchers.emplace_back( x, y, 0 );
+        }
+    }
+    std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>> lines;
+    for( size_t i = 0; i < watchers.size(); ++i ) {
+        for( size_t j = i + 1; j < watchers.size(); ++j ) {
+            lines.emplace_back( watchers[i], watchers[j] );
+        }
+    }
+
+    // Moving the pillars around throws away the lines sees() remembers
+    set_pillars( false );
+    set_pillars( true );
+    here.cache_sight_lines( lines );
+    const std::vector<bool> cast_ahead = lines_seen( lines );
+
+    set_pillars( false );
+    set_pillars( true );
+    const std::vector<bool> on_demand = lines_seen( lines );
+
+    CHECK( cast_ahead == on_demand );
+    CHECK( std::count( on_demand.begin(), on_demand.end(), true ) > 0 );
+    CHECK( std::count( on_demand.begin(), on_demand.end(), false ) > 0 );
+}
+
+TEST_CASE( "sight_lines_are_cast_from_the_monster_that_looks", "[vision]" )
+{
+    clear_map();
+    calendar::turn = midday;
+    monster &first = spawn_and_clear( { 30, 30, 0 }, true );
+    monster &second = spawn_and_clear( { 36, 30, 0 }, true );
+    const tripoint_bub_ms first_pos = first.pos_bub();
+    const tripoint_bub_ms second_pos = second.pos_bub();
+    const auto cast = [&]( const tripoint_bub_ms & from, const tripoint_bub_ms & to ) {
+        const std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>> lines =
+            monster_sight_lines( get_map() );
+        return std::find( lines.begin(), lines.end(), std::make_pair( from, to ) ) != lines.end();
+    };
+
+    SECTION( "neither watches the other" ) {
+        CHECK_FALSE( cast( first_pos, second_pos ) );
+        CHECK_FALSE( cast( second_pos, first_pos ) );
+    }
+    SECTION( "only the first one watches" ) {
+        first.friendly = -1;
+        CHECK( cast( first_pos, second_pos ) );
+        CHECK_FALSE( cast( second_pos, first_pos ) );
+    }
+    SECTION( "only the second one watches" ) {
+        second.friendly = -1;
+        CHECK( cast( second_pos, first_pos ) );
+        CHECK_FALSE( cast( first_pos, second_pos ) );
+    }
+    clear_map();
+}
+
+TEST_CASE( "monster_sight_lines_benchmark", "[.][vision][benchmark]" )
+{
+    clear_map();
+    calendar::turn = midday;
+    map &here = get_map();
+    set_pillars( true );
+    // Tame ones and wild ones watching each other, all over the pillars
+    int num_monsters = 0;
+    for( int x = 22; x < 98; x += 5 ) {
+        for( int y = 21; y < 99; y += 6 ) {
+            monster &critter = spawn_test_monster( "mon_zombie", { x, y, 0 } );
+            if( ++num_monsters % 2 == 0 ) {
+                critter.friendly = -1;
+            }
+        }
+    }
+    const std::vector<std::pair<tripoint_bub_ms, tripoint_bub_ms>> lines = monster_sight_lines( here );
+
+    // Moving the pillars around throws away the lines sees() remembers, so every run starts over
+    report_benchmark( "monster sight lines cast on demand", "lines", 100, [&]() {
+        set_pillars( false );
+        set_pillars( true );
+        return static_cast<long long>( lines_seen( lines ).size() );
+    } );
+    report_benchmark( "monster sight lines cast ahead", "lines", 100, [&]() {
+        set_pillars( false );
+        set_pillars( true );
+        here.cache_sight_lines( monster_sight_lines( here ) );
+        return static_cast<long long>( lines_seen( lines ).size() );
+    } );
+    clear_map();
+}
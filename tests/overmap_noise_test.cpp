@@ -1,6 +1,8 @@
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "cata_catch.h"
 #include "coordinates.h"
@@ -69,3 +71,32 @@ TEST_CASE( "om_noise_layer_lake_export", "[.]" )
     export_raw_noise( "lake-map-raw.pgm", f, OMAPX * 5, OMAPY * 5 );
     export_interpreted_noise( "lake-map-interp.pgm", f, OMAPX * 5, OMAPY * 5, 0.25 );
 }
+
+TEST_CASE( "om_noise_field_matches_layer", "[overmap][omnoise]" )
+{
+    const point_abs_omt base( OMAPX * 3, OMAPY * -2 );
+    const unsigned seed = 1920237457;
+    const auto check_field = [&]( std::unique_ptr<om_noise::om_noise_layer> field_layer,
+    const om_noise::om_noise_layer & layer ) {
+        om_noise::om_noise_field field( std::move( field_layer ) );
+        field.evaluate();
+        const int margin = om_noise::om_noise_field::margin;
+        for( int x = -margin - 1; x < OMAPX + margin + 1; x++ ) {
+            for( int y = -margin - 1; y < OMAPY + margin + 1; y++ ) {
+                const point_om_omt p( x, y );
+                if( field.noise_at( p ) != layer.noise_at( p ) ) {
+                    FAIL_CHECK( "noise differs at " << p.to_string() );
+                    return;
+                }
+            }
+        }
+    };
+    check_field( std::make_unique<om_noise::om_noise_layer_forest>( base, seed ),
+                 om_noise::om_noise_layer_forest( base, seed ) );
+    check_field( std::make_unique<om_noise::om_noise_layer_floodplain>( base, seed ),
+                 om_noise::om_noise_layer_floodplain( base, seed ) );
+    check_field( std::make_unique<om_noise::om_noise_layer_lake>( base, seed ),
+                 om_noise::om_noise_layer_lake( base, seed ) );
+    check_field( std::make_unique<om_noise::om_noise_layer_ocean>( base, seed ),
+                 om_noise::om_noise_layer_ocean( base, seed ) );
+}
@@ -150,6 +150,37 @@ TEST_CASE( "default_overmap_generation_has_non_mandatory_specials_at_origin", "[
     CHECK( found_optional == true );
 }
 
+static std::vector<oter_id> generate_overmap_terrain( const point_abs_om &where, bool pregenerate )
+{
+    overmap_buffer.clear();
+    if( pregenerate ) {
+        overmap_buffer.pregenerate( where );
+        REQUIRE( overmap_buffer.has_pregenerated_noise( where, g->get_seed() ) );
+    }
+    rng_set_engine_seed( 4242 );
+    const overmap &om = overmap_buffer.get( where );
+    // Generating the overmap took the pregenerated noise, rather than evaluating its own
+    REQUIRE_FALSE( overmap_buffer.has_pregenerated_noise( where, g->get_seed() ) );
+    std::vector<oter_id> terrain;
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+        for( int y = 0; y < OMAPY; ++y ) {
+            for( int x = 0; x < OMAPX; ++x ) {
+                terrain.push_back( om.ter( tripoint_om_omt( x, y, z ) ) );
+            }
+        }
+    }
+    return terrain;
+}
+
+TEST_CASE( "pregenerated_overmap_matches_synchronous_generation", "[overmap][slow]" )
+{
+    const point_abs_om where( 7, -7 );
+    const std::vector<oter_id> synchronous = generate_overmap_terrain( where, false );
+    const std::vector<oter_id> pregenerated = generate_overmap_terrain( where, true );
+    CHECK( synchronous == pregenerated );
+    overmap_buffer.clear();
+}
+
 TEST_CASE( "is_ot_match", "[overmap][terrain]" )
 {
     SECTION( "exact match" ) {
@@ -0,0 +1,99 @@
+#include <vector>
+
+#include "benchmark_helpers.h"
+#include "cata_catch.h"
+#include "coordinates.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "map_scale_constants.h"
+#include "pathfinding.h"
+#include "point.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_wall_metal( "t_wall_metal" );
+
+static const tripoint_bub_ms swarm_target( 60, 60, 0 );
+
+// Walls across the whole reality bubble with staggered gaps in them, so routes have to wind
+// their way through
+static void build_walls( map &here )
+{
+    for( int x = 11; x < MAPSIZE_X; x += 20 ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            if( ( x + y ) % 16 >= 3 ) {
+                here.ter_set( tripoint_bub_ms( x, y, 0 ), ter_t_wall_metal );
+            }
+        }
+    }
+    here.set_transparency_cache_dirty( 0 );
+    here.set_pathfinding_cache_dirty( 0 );
+    here.build_map_cache( 0 );
+}
+
+// Where the monsters of the swarm start out, all around the edge of the reality bubble
+static std::vector<tripoint_bub_ms> swarm_positions()
+{
+    std::vector<tripoint_bub_ms> ret;
+    for( int i = 1; i < MAPSIZE_X - 1; i += 4 ) {
+        ret.emplace_back( i, 1, 0 );
+        ret.emplace_back( i, MAPSIZE_Y - 2, 0 );
+        ret.emplace_back( 1, i, 0 );
+        ret.emplace_back( MAPSIZE_X - 2, i, 0 );
+    }
+    return ret;
+}
+
+// Roughly what a zombie routes with
+static pathfinding_settings swarm_settings()
+{
+    pathfinding_settings settings;
+    settings.max_dist = MAPSIZE_X;
+    settings.max_length = MAPSIZE_X * 10;
+    settings.avoid_traps = true;
+    settings.avoid_sharp = true;
+    return settings;
+}
+
+static int route_swarm( const map &here, const std::vector<tripoint_bub_ms> &swarm )
+{
+    const pathfinding_settings settings = swarm_settings();
+    int steps = 0;
+    for( const tripoint_bub_ms &p : swarm ) {
+        steps += here.route( p, pathfinding_target::adjacent( swarm_target ), settings ).size();
+    }
+    return steps;
+}
+
+static int route_swarm_shared( const map &here, const std::vector<tripoint_bub_ms> &swarm )
+{
+    const pathfinding_settings settings = swarm_settings();
+    int steps = 0;
+    for( const tripoint_bub_ms &p : swarm ) {
+        steps += here.route_shared( p, pathfinding_target::adjacent( swarm_target ), settings,
+        []( const tripoint_bub_ms & ) {
+            return false;
+        } ).size();
+    }
+    return steps;
+}
+
+TEST_CASE( "pathfinding_monster_swarm_benchmark", "[.][pathfinding][benchmark]" )
+{
+    clear_map();
+    map &here = get_map();
+    build_walls( here );
+    const std::vector<tripoint_bub_ms> swarm = swarm_positions();
+
+    const pathfinding_settings settings = swarm_settings();
+    for( const tripoint_bub_ms &p : swarm ) {
+        CAPTURE( p );
+        REQUIRE( !here.route( p, pathfinding_target::adjacent( swarm_target ), settings ).empty() );
+    }
+
+    report_benchmark( "swarm across the reality bubble", "route steps found", 1, [&]() {
+        return route_swarm( here, swarm );
+    } );
+    report_benchmark( "swarm sharing its routes", "route steps found", 1, [&]() {
+        return route_swarm_shared( here, swarm );
+    } );
+}
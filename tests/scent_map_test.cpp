@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <array>
+
+#include "avatar.h"
+#include "benchmark_helpers.h"
+#include "calendar.h"
+#include "cata_catch.h"
+#include "coordinates.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "map_scale_constants.h"
+#include "mapdata.h"
+#include "player_helpers.h"
+#include "point.h"
+#include "scent_map.h"
+#include "type_id.h"
+
+static const ter_str_id ter_t_brick_wall( "t_brick_wall" );
+static const ter_str_id ter_t_door_locked( "t_door_locked" );
+
+// Same as in scent_map.cpp
+static constexpr int scent_radius = 40;
+
+using scent_grid = std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X>;
+
+// Walls and doors all over the place, and the avatar in the middle of it all
+static void set_up_houses()
+{
+    clear_map();
+    clear_avatar();
+    // Scent stops spreading when the avatar stands still for long enough
+    set_time( calendar::turn_zero );
+    map &here = get_map();
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            if( x % 12 == 3 || y % 12 == 3 ) {
+                const bool door = ( x + y ) % 12 == 6;
+                here.ter_set( tripoint_bub_ms( x, y, 0 ), door ? ter_t_door_locked : ter_t_brick_wall );
+            }
+        }
+    }
+    REQUIRE( here.has_flag_ter( ter_furn_flag::TFLAG_NO_SCENT, tripoint_bub_ms( 3, 4, 0 ) ) );
+    REQUIRE( here.has_flag( ter_furn_flag::TFLAG_REDUCE_SCENT, tripoint_bub_ms( 3, 3, 0 ) ) );
+
+    scent_map &scent = get_scent();
+    scent.reset();
+    for( int x = 0; x < MAPSIZE_X; x += 5 ) {
+        for( int y = 0; y < MAPSIZE_Y; y += 7 ) {
+            scent.set( tripoint_bub_ms( x, y, 0 ), 500 + ( x * y ) % 500 );
+        }
+    }
+}
+
+static scent_grid current_scent()
+{
+    const scent_map &scent = get_scent();
+    scent_grid ret;
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            ret[x][y] = scent.get( tripoint_bub_ms( x, y, 0 ) );
+        }
+    }
+    return ret;
+}
+
+// How scent spread before it was vectorized, one square at a time
+static void diffuse_slowly( scent_grid &grscent, const tripoint_bub_ms &center )
+{
+    const map &here = get_map();
+    const int diffusivity = 100;
+    const auto blocks = [&]( int x, int y ) {
+        return here.has_flag_ter( ter_furn_flag::TFLAG_NO_SCENT, tripoint_bub_ms( x, y, 0 ) );
+    };
+    const auto reduces = [&]( int x, int y ) {
+        return here.has_flag( ter_furn_flag::TFLAG_REDUCE_SCENT, tripoint_bub_ms( x, y, 0 ) );
+    };
+    scent_grid sum_3_scent_y{};
+    scent_grid squares_used_y{};
+    for( int x = center.x() - scent_radius - 1; x <= center.x() + scent_radius + 1; ++x ) {
+        for( int y = center.y() - scent_radius; y <= center.y() + scent_radius; ++y ) {
+            for( int i = y - 1; i <= y + 1; ++i ) {
+                if( !blocks( x, i ) ) {
+                    const int weight = reduces( x, i ) ? 2 : 10;
+                    sum_3_scent_y[x][y] += weight * grscent[x][i];
+                    squares_used_y[x][y] += weight;
+                }
+            }
+        }
+    }
+    for( int x = center.x() - scent_radius; x <= center.x() + scent_radius; ++x ) {
+        for( int y = center.y() - scent_radius; y <= center.y() + scent_radius; ++y ) {
+            if( blocks( x, y ) ) {
+                grscent[x][y] = 0;
+                continue;
+            }
+            const int squares_used = squares_used_y[x - 1][y] + squares_used_y[x][y] +
+                                     squares_used_y[x + 1][y];
+            const int this_diffusivity = reduces( x, y ) ? diffusivity / 5 : diffusivity;
+            int temp_scent = grscent[x][y] * ( 10 * 1000 - squares_used * this_diffusivity );
+            temp_scent -= grscent[x][y] * this_diffusivity * ( 90 - squares_used ) / 5;
+            grscent[x][y] = ( temp_scent + this_diffusivity * ( sum_3_scent_y[x - 1][y] +
+                              sum_3_scent_y[x][y] + sum_3_scent_y[x + 1][y] ) ) / ( 1000 * 10 );
+        }
+    }
+}
+
+static void check_against_slow_diffusion( int turns )
+{
+    map &here = get_map();
+    const tripoint_bub_ms center = get_avatar().pos_bub();
+    scent_grid expected = current_scent();
+    for( int i = 0; i < turns; ++i ) {
+        get_scent().update( center, here );
+        diffuse_slowly( expected, center );
+    }
+    CHECK( current_scent() == expected );
+}
+
+TEST_CASE( "scent_diffusion_matches_one_square_at_a_time", "[scent]" )
+{
+    set_up_houses();
+    map &here = get_map();
+
+    SECTION( "a few turns" ) {
+        check_against_slow_diffusion( 5 );
+    }
+    SECTION( "walls built and knocked down in between" ) {
+        const tripoint_bub_ms center = get_avatar().pos_bub();
+        check_against_slow_diffusion( 2 );
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            here.ter_set( center + tripoint( 2, y - center.y(), 0 ), ter_t_brick_wall );
+            here.ter_set( tripoint_bub_ms( 15, y, 0 ), ter_t_door_locked );
+        }
+        check_against_slow_diffusion( 2 );
+        here.ter_set( tripoint_bub_ms( 15, 15, 0 ), ter_t_brick_wall );
+        check_against_slow_diffusion( 2 );
+    }
+    get_scent().reset();
+}
+
+TEST_CASE( "scent_diffusion_benchmark", "[.][scent][benchmark]" )
+{
+    set_up_houses();
+    map &here = get_map();
+    const tripoint_bub_ms center = get_avatar().pos_bub();
+    scent_map &scent = get_scent();
+
+    scent_grid slow = current_scent();
+    report_benchmark( "houses", "turns of scent diffusion", 100, [&]() {
+        scent.update( center, here );
+        return 1;
+    } );
+    report_benchmark( "houses, one square at a time", "turns of scent diffusion", 100, [&]() {
+        diffuse_slowly( slow, center );
+        return 1;
+    } );
+    scent.reset();
+}
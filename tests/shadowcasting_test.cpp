@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include "benchmark_helpers.h"
 #include "cata_catch.h"
 #include "coordinates.h"
 #include "cuboid_rectangle.h"
@@ -18,6 +19,7 @@
 #include "map.h"
 #include "map_scale_constants.h"
 #include "mdarray.h"
+#include "options_helpers.h"
 #include "point.h"
 #include "rng.h"
 #include "shadowcasting.h"
@@ -1141,3 +1143,75 @@ TEST_CASE( "bresenham_vs_shadowcasting", "[.]" )
 {
     shadowcasting_runoff( 1, true );
 }
+
+// Random transparency and floors on every z-level, with two outputs to cast them into.
+struct zlight_test_grids {
+    std::array<cata::mdarray<float, point_bub_ms>, OVERMAP_LAYERS> transparency_cache = {};
+    std::array<cata::mdarray<bool, point_bub_ms>, OVERMAP_LAYERS> floor_cache = {};
+    std::array<cata::mdarray<float, point_bub_ms>, OVERMAP_LAYERS> one_thread = {};
+    std::array<cata::mdarray<float, point_bub_ms>, OVERMAP_LAYERS> threads = {};
+
+    array_of_grids_of<const float> transparency_caches;
+    array_of_grids_of<const bool> floor_caches;
+    array_of_grids_of<float> one_thread_outputs;
+    array_of_grids_of<float> thread_outputs;
+
+    zlight_test_grids() {
+        std::uniform_int_distribution<int> floor_distribution( 0, 3 );
+        for( int z = 0; z < OVERMAP_LAYERS; z++ ) {
+            randomly_fill_transparency( transparency_cache[z] );
+            floor_cache[z].fill_from_callable( [&floor_distribution]() {
+                return floor_distribution( rng_get_engine() ) == 0;
+            } );
+            transparency_caches[z] = &transparency_cache[z];
+            floor_caches[z] = &floor_cache[z];
+            one_thread_outputs[z] = &one_thread[z];
+            thread_outputs[z] = &threads[z];
+        }
+    }
+
+    void cast( const array_of_grids_of<float> &outputs ) const {
+        const tripoint_bub_ms origin( 65, 65, 0 );
+        cast_zlight<float, sight_calc, sight_check, accumulate_transparency>(
+            outputs, transparency_caches, floor_caches, origin, 0, 1.0 );
+    }
+};
+
+TEST_CASE( "shadowcasting_3d_on_threads_matches_one_thread", "[shadowcasting]" )
+{
+    std::unique_ptr<zlight_test_grids> grids = std::make_unique<zlight_test_grids>();
+    {
+        override_option threads( "SHADOWCASTING_THREADS", "1" );
+        grids->cast( grids->one_thread_outputs );
+    }
+    override_option threads( "SHADOWCASTING_THREADS", "4" );
+    grids->cast( grids->thread_outputs );
+
+    for( int z = 0; z < OVERMAP_LAYERS; z++ ) {
+        CAPTURE( z - OVERMAP_DEPTH );
+        int mismatches = 0;
+        for( int x = 0; x < MAPSIZE_X; ++x ) {
+            for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                mismatches += grids->one_thread[z][x][y] != grids->threads[z][x][y];
+            }
+        }
+        CHECK( mismatches == 0 );
+    }
+}
+
+TEST_CASE( "shadowcasting_3d_on_threads_benchmark", "[.][shadowcasting][benchmark]" )
+{
+    std::unique_ptr<zlight_test_grids> grids = std::make_unique<zlight_test_grids>();
+    {
+        override_option threads( "SHADOWCASTING_THREADS", "1" );
+        report_benchmark( "3d shadowcasting on one thread", "casts", 100, [&]() {
+            grids->cast( grids->one_thread_outputs );
+            return 1LL;
+        } );
+    }
+    override_option threads( "SHADOWCASTING_THREADS", "0" );
+    report_benchmark( "3d shadowcasting on all threads", "casts", 100, [&]() {
+        grids->cast( grids->thread_outputs );
+        return 1LL;
+    } );
+}
@@ -96,7 +96,7 @@ void formatter::format( TextJsonIn &jsin, JsonOut &jsout, int depth, bool force_
         }
         // Write the string
         jsout.write_separator();
-        *jsout.get_stream() << str;
+        jsout.write_raw( str );
         jsout.set_need_separator();
     } else if( jsin.test_number() ) {
         // Have to introspect into the string to distinguish integers from floats.
@@ -126,7 +126,7 @@ void formatter::format( TextJsonIn &jsin, JsonOut &jsout, int depth, bool force_
                 double_str += "0";
             }
             jsout.write_separator();
-            *jsout.get_stream() << double_str;
+            jsout.write_raw( double_str );
             jsout.set_need_separator();
         }
     } else if( jsin.test_bool() ) {
@@ -39,12 +39,43 @@ def getVehicleTemplates():
     return allTemplates
 
 
+QUAD_MAGIC = b"CDDAQUAD"
+QUAD_SECTION_OTHER = 4
+
+
+def readBinaryQuad(data):
+    """The json objects of the submaps in a binary quad file, see src/quad_file.h"""
+    submaps = []
+    pos = len(QUAD_MAGIC) + 4
+    count = data[pos]
+    pos += 1
+    for _ in range(count):
+        # coordinates and version
+        pos += 16
+        sectionCount = data[pos]
+        pos += 1
+        submap = {"vehicles": []}
+        for _ in range(sectionCount):
+            kind = data[pos]
+            length = int.from_bytes(data[pos + 1:pos + 5], "little")
+            pos += 5
+            if kind == QUAD_SECTION_OTHER:
+                submap.update(json.loads(data[pos:pos + length]))
+            pos += length
+        submaps.append(submap)
+    return submaps
+
+
 def getVehicleInstances(mapPath):
     vehicles = []
-    with open(mapPath, encoding="utf-8") as mapFile:
-        mapData = json.load(mapFile)
+    with open(mapPath, "rb") as mapFile:
+        data = mapFile.read()
+        if data.startswith(QUAD_MAGIC):
+            mapData = readBinaryQuad(data)
+        else:
+            mapData = json.loads(data)
         for i in range(0, len(mapData)):
-            for vehicle in mapData[i]["vehicles"]:
+            for vehicle in mapData[i].get("vehicles", []):
                 if argsDict["vehicle"] is not None:
                     if argsDict["vehicle"] == vehicle["name"]:
                         vehicles.append(vehicle)